@@ -0,0 +1,205 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define ADJACENCY_X86 1 // x86-64 上 SSE2 是基线指令集，AVX2 运行时检测
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang 需要为 AVX2 函数单独打开指令集，其余代码仍按基线编译；MSVC 不需要
+#if defined(ADJACENCY_X86) && (defined(__GNUC__) || defined(__clang__))
+#define ADJACENCY_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define ADJACENCY_TARGET_AVX2
+#endif
+
+// 周围雷数计算内核，直接处理 Board 的带边框字节数组（见 board.h 的字节布局）：
+// bit 4 为雷，低 4 位写入周围雷数。边框格子不是雷，所以不需要任何越界判断。
+//
+// 采用可分离的滑动求和：先对每行求水平方向相邻三格的雷数之和，
+// 再把上、中、下三行的水平和相加并减去自身，每格只做常数次无分支加法，与雷密度无关。
+// 两步都是逐字节的移位加法，另有 SSE2 / AVX2 版本，运行时按 CPU 选择。
+
+// 水平和：out[c] = 第 c-1、c、c+1 格的雷数之和，处理第 from..cols 列
+inline void adjacencyHorizontalTail(const uint8_t* row, uint8_t* out, int from, int cols) {
+    for (int c = from; c <= cols; ++c) {
+        out[c] = (uint8_t)(((row[c - 1] >> 4) & 1) + ((row[c] >> 4) & 1) + ((row[c + 1] >> 4) & 1));
+    }
+}
+
+// 三行水平和相加减去自身，写回低 4 位；雷格子的计数保持为 0
+inline void adjacencyCombineTail(uint8_t* row, const uint8_t* prev, const uint8_t* cur, const uint8_t* next, int from, int cols) {
+    for (int c = from; c <= cols; ++c) {
+        uint8_t mine = (row[c] >> 4) & 1;
+        uint8_t count = (uint8_t)(prev[c] + cur[c] + next[c] - mine);
+        row[c] = (uint8_t)((row[c] & 0xF0) | (count & (uint8_t)(mine - 1)));
+    }
+}
+
+inline void adjacencyHorizontalScalar(const uint8_t* row, uint8_t* out, int cols) {
+    adjacencyHorizontalTail(row, out, 1, cols);
+}
+
+inline void adjacencyCombineScalar(uint8_t* row, const uint8_t* prev, const uint8_t* cur, const uint8_t* next, int cols) {
+    adjacencyCombineTail(row, prev, cur, next, 1, cols);
+}
+
+#ifdef ADJACENCY_X86
+
+// 每次处理 16 格；读 c-1 到 c+16，不会越过本行右边框
+inline void adjacencyHorizontalSSE2(const uint8_t* row, uint8_t* out, int cols) {
+    const __m128i one = _mm_set1_epi8(1);
+    int c = 1;
+    for (; c + 16 <= cols + 1; c += 16) {
+        // 16 位移位会把高字节的位移进低字节的高 4 位，与 1 相与后只剩雷位
+        __m128i l = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128((const __m128i*)(row + c - 1)), 4), one);
+        __m128i m = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128((const __m128i*)(row + c)), 4), one);
+        __m128i r = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128((const __m128i*)(row + c + 1)), 4), one);
+        _mm_storeu_si128((__m128i*)(out + c), _mm_add_epi8(_mm_add_epi8(l, m), r));
+    }
+    adjacencyHorizontalTail(row, out, c, cols);
+}
+
+inline void adjacencyCombineSSE2(uint8_t* row, const uint8_t* prev, const uint8_t* cur, const uint8_t* next, int cols) {
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i high = _mm_set1_epi8((char)0xF0);
+    const __m128i zero = _mm_setzero_si128();
+    int c = 1;
+    for (; c + 16 <= cols + 1; c += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(row + c));
+        __m128i mine = _mm_and_si128(_mm_srli_epi16(v, 4), one);
+        __m128i sum = _mm_add_epi8(_mm_loadu_si128((const __m128i*)(prev + c)), _mm_loadu_si128((const __m128i*)(cur + c)));
+        sum = _mm_sub_epi8(_mm_add_epi8(sum, _mm_loadu_si128((const __m128i*)(next + c))), mine);
+        __m128i safe = _mm_cmpeq_epi8(mine, zero);
+        _mm_storeu_si128((__m128i*)(row + c), _mm_or_si128(_mm_and_si128(v, high), _mm_and_si128(sum, safe)));
+    }
+    adjacencyCombineTail(row, prev, cur, next, c, cols);
+}
+
+// 与 SSE2 版本相同，每次处理 32 格
+ADJACENCY_TARGET_AVX2 inline void adjacencyHorizontalAVX2(const uint8_t* row, uint8_t* out, int cols) {
+    const __m256i one = _mm256_set1_epi8(1);
+    int c = 1;
+    for (; c + 32 <= cols + 1; c += 32) {
+        __m256i l = _mm256_and_si256(_mm256_srli_epi16(_mm256_loadu_si256((const __m256i*)(row + c - 1)), 4), one);
+        __m256i m = _mm256_and_si256(_mm256_srli_epi16(_mm256_loadu_si256((const __m256i*)(row + c)), 4), one);
+        __m256i r = _mm256_and_si256(_mm256_srli_epi16(_mm256_loadu_si256((const __m256i*)(row + c + 1)), 4), one);
+        _mm256_storeu_si256((__m256i*)(out + c), _mm256_add_epi8(_mm256_add_epi8(l, m), r));
+    }
+    adjacencyHorizontalTail(row, out, c, cols);
+}
+
+ADJACENCY_TARGET_AVX2 inline void adjacencyCombineAVX2(uint8_t* row, const uint8_t* prev, const uint8_t* cur, const uint8_t* next, int cols) {
+    const __m256i one = _mm256_set1_epi8(1);
+    const __m256i high = _mm256_set1_epi8((char)0xF0);
+    const __m256i zero = _mm256_setzero_si256();
+    int c = 1;
+    for (; c + 32 <= cols + 1; c += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(row + c));
+        __m256i mine = _mm256_and_si256(_mm256_srli_epi16(v, 4), one);
+        __m256i sum = _mm256_add_epi8(_mm256_loadu_si256((const __m256i*)(prev + c)), _mm256_loadu_si256((const __m256i*)(cur + c)));
+        sum = _mm256_sub_epi8(_mm256_add_epi8(sum, _mm256_loadu_si256((const __m256i*)(next + c))), mine);
+        __m256i safe = _mm256_cmpeq_epi8(mine, zero);
+        _mm256_storeu_si256((__m256i*)(row + c), _mm256_or_si256(_mm256_and_si256(v, high), _mm256_and_si256(sum, safe)));
+    }
+    adjacencyCombineTail(row, prev, cur, next, c, cols);
+}
+
+// CPU 和操作系统是否都支持 AVX2（MSVC 需要自己检查 OSXSAVE 和 XCR0）
+inline bool cpuHasAVX2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    if (!(info[2] & (1 << 27)) || (_xgetbv(0) & 6) != 6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // ADJACENCY_X86
+
+// 可选的内核实现
+enum AdjacencyKernel { ADJACENCY_SCALAR, ADJACENCY_SSE2, ADJACENCY_AVX2 };
+
+inline const char* adjacencyKernelName(AdjacencyKernel k) {
+    switch (k) {
+        case ADJACENCY_SSE2: return "SSE2";
+        case ADJACENCY_AVX2: return "AVX2";
+        default: return "scalar";
+    }
+}
+
+inline bool adjacencyKernelSupported(AdjacencyKernel k) {
+#ifdef ADJACENCY_X86
+    return k != ADJACENCY_AVX2 || cpuHasAVX2();
+#else
+    return k == ADJACENCY_SCALAR;
+#endif
+}
+
+// 当前 CPU 上最快的内核，只检测一次
+inline AdjacencyKernel bestAdjacencyKernel() {
+    static const AdjacencyKernel best = adjacencyKernelSupported(ADJACENCY_AVX2) ? ADJACENCY_AVX2
+                                      : adjacencyKernelSupported(ADJACENCY_SSE2) ? ADJACENCY_SSE2
+                                      : ADJACENCY_SCALAR;
+    return best;
+}
+
+// 用指定内核计算整张棋盘；kernel 必须被当前 CPU 支持
+inline void computeAdjacencyWith(AdjacencyKernel kernel, uint8_t* cells, int rows, int cols, int stride) {
+    typedef void (*HorizontalFn)(const uint8_t*, uint8_t*, int);
+    typedef void (*CombineFn)(uint8_t*, const uint8_t*, const uint8_t*, const uint8_t*, int);
+    HorizontalFn horizontal = adjacencyHorizontalScalar;
+    CombineFn combine = adjacencyCombineScalar;
+#ifdef ADJACENCY_X86
+    if (kernel == ADJACENCY_SSE2) {
+        horizontal = adjacencyHorizontalSSE2;
+        combine = adjacencyCombineSSE2;
+    } else if (kernel == ADJACENCY_AVX2) {
+        horizontal = adjacencyHorizontalAVX2;
+        combine = adjacencyCombineAVX2;
+    }
+#else
+    (void)kernel;
+#endif
+
+    // 三行滚动的水平和缓冲区，每行只读一次棋盘
+    std::vector<uint8_t> buffer(3 * (size_t)stride, 0);
+    uint8_t* prev = buffer.data(); // 上一行的水平和，第 0 行是边框，全为 0
+    uint8_t* cur = prev + stride;
+    uint8_t* next = cur + stride;
+
+    horizontal(cells + stride, cur, cols);
+    for (int r = 1; r <= rows; ++r) {
+        uint8_t* row = cells + (size_t)r * stride;
+        if (r < rows) {
+            horizontal(row + stride, next, cols);
+        } else {
+            memset(next, 0, stride); // 最后一行下面是边框
+        }
+        combine(row, prev, cur, next, cols);
+        uint8_t* t = prev;
+        prev = cur;
+        cur = next;
+        next = t;
+    }
+}
+
+inline void computeAdjacencyScalar(uint8_t* cells, int rows, int cols, int stride) {
+    computeAdjacencyWith(ADJACENCY_SCALAR, cells, rows, cols, stride);
+}
+
+// 运行时选择最快的内核
+inline void computeAdjacencyFast(uint8_t* cells, int rows, int cols, int stride) {
+    computeAdjacencyWith(bestAdjacencyKernel(), cells, rows, cols, stride);
+}
@@ -0,0 +1,452 @@
+#pragma once
+
+// 雷概率分析：只根据玩家看得到的信息（已揭示的数字、旗子、总雷数）计算每个未知格是雷的精确概率。
+//
+// 未知格分为两类：边界格（与某个已揭示的数字相邻）和内部格。每个已揭示的数字给出一个约束：
+// 周围边界格中的雷数 = 数字 - 周围旗数。共享约束的边界格用并查集连成分量，各分量互不影响，分别计算：
+//   分量内的格子排成一列（广度优先，相关的格子挨在一起），从前往后逐格决定是否为雷。
+//   前 i 格决定之后，只有“一部分格子已决定、一部分未决定”的约束还影响后面，
+//   把这些约束还差的雷数作为状态，状态相同的部分解合并计数（记忆化），
+//   每个状态保存按已放雷数分开的解数。正向、反向各扫一遍，就得到每格为雷的解数，
+//   计算量随“同时未完成的约束数”增长，而不是随解的个数指数增长。
+// 最后按总雷数合并：边界上共放 m 个雷时，其余 R - m 个雷在 U 个内部格中有 C(U, R - m) 种放法。
+// 组合数用对数阶乘表取对数、减去最大值后再取指数，只需要相对大小，不需要大整数；
+// 正向、反向每算完一层就按该层最大值归一化并记下缩放的对数，合并时再还原相对大小，大分量也不会溢出。
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "board.h"
+
+class ProbabilityAnalyzer {
+public:
+    // 计算 board 上每个未知格（隐藏且未插旗）是雷的概率，按 Board 下标写入 probability，其余格子为 -1。
+    // 旗子当作雷。局面自相矛盾（例如旗插错）时返回 false
+    bool analyze(const Board& board, std::vector<double>& probability) {
+        const uint8_t* cells = board.data();
+        const int* nb = board.neighbours();
+        probability.assign((size_t)(board.rows() + 2) * board.stride(), -1.0);
+        frontierId_.assign(probability.size(), -1);
+        frontier_.clear();
+        constraints_.clear();
+        components_ = largest_ = 0;
+
+        // 收集约束和边界格
+        int flags = 0, unknown = 0;
+        for (int i = 0; i < board.rows(); ++i) {
+            for (int j = 0; j < board.cols(); ++j) {
+                int idx = board.index(i, j);
+                uint8_t st = cells[idx] & Board::STATUS_MASK;
+                flags += st == Board::FLAGGED_BITS;
+                unknown += st == 0;
+                if (st != Board::REVEALED_BITS) continue;
+                Constraint c;
+                c.need = cells[idx] & Board::COUNT_MASK;
+                for (int k = 0; k < 8; ++k) {
+                    int n = idx + nb[k];
+                    uint8_t ns = cells[n] & Board::STATUS_MASK;
+                    if (ns == Board::FLAGGED_BITS) {
+                        c.need--;
+                    } else if (ns == 0) {
+                        if (frontierId_[n] < 0) {
+                            frontierId_[n] = (int)frontier_.size();
+                            frontier_.push_back(n);
+                        }
+                        c.cells.push_back(frontierId_[n]);
+                    }
+                }
+                if (c.need < 0 || c.need > (int)c.cells.size()) return false;
+                if (!c.cells.empty()) constraints_.push_back(std::move(c));
+            }
+        }
+        int remaining = board.mineCount() - flags;
+        int interior = unknown - (int)frontier_.size();
+        if (remaining < 0 || remaining > unknown) return false;
+
+        // 并查集分量
+        parent_.resize(frontier_.size());
+        local_.resize(frontier_.size());
+        std::iota(parent_.begin(), parent_.end(), 0);
+        for (const auto& c : constraints_) {
+            for (size_t k = 1; k < c.cells.size(); ++k) unite(c.cells[0], c.cells[k]);
+        }
+        std::vector<int> componentOf(frontier_.size(), -1);
+        std::vector<std::vector<int>> componentCells, componentConstraints;
+        for (size_t f = 0; f < frontier_.size(); ++f) {
+            int root = find((int)f);
+            if (componentOf[root] < 0) {
+                componentOf[root] = (int)componentCells.size();
+                componentCells.emplace_back();
+                componentConstraints.emplace_back();
+            }
+            componentOf[f] = componentOf[root];
+            componentCells[componentOf[f]].push_back((int)f);
+        }
+        for (size_t c = 0; c < constraints_.size(); ++c) {
+            componentConstraints[componentOf[constraints_[c].cells[0]]].push_back((int)c);
+        }
+        components_ = (int)componentCells.size();
+
+        // 每个分量：按放雷数分开的解数 W[k]，以及每格为雷的解数 S[格][k]
+        std::vector<std::vector<double>> W(components_);
+        std::vector<std::vector<std::vector<double>>> S(components_);
+        for (int c = 0; c < components_; ++c) {
+            largest_ = std::max(largest_, (int)componentCells[c].size());
+            if (!countComponent(componentCells[c], componentConstraints[c], W[c], S[c])) return false;
+        }
+
+        // 内部格放 R - m 个雷的相对放法数 G[m]
+        int frontierCount = (int)frontier_.size();
+        std::vector<double> G(frontierCount + 1, 0.0);
+        double maxLog = -INFINITY;
+        std::vector<double> logG(frontierCount + 1, -INFINITY);
+        for (int m = 0; m <= frontierCount; ++m) {
+            int rest = remaining - m;
+            if (rest < 0 || rest > interior) continue;
+            logG[m] = logChoose(interior, rest);
+            maxLog = std::max(maxLog, logG[m]);
+        }
+        if (maxLog == -INFINITY) return false;
+        for (int m = 0; m <= frontierCount; ++m) G[m] = logG[m] == -INFINITY ? 0.0 : std::exp(logG[m] - maxLog);
+
+        // 除分量 c 之外所有分量的卷积：前缀积 × 后缀积
+        std::vector<std::vector<double>> prefix(components_ + 1), suffix(components_ + 1);
+        prefix[0] = suffix[components_] = std::vector<double>(1, 1.0);
+        for (int c = 0; c < components_; ++c) prefix[c + 1] = convolve(prefix[c], W[c]);
+        for (int c = components_ - 1; c >= 0; --c) suffix[c] = convolve(suffix[c + 1], W[c]);
+
+        for (int c = 0; c < components_; ++c) {
+            std::vector<double> others = convolve(prefix[c], suffix[c + 1]);
+            std::vector<double> w(W[c].size(), 0.0);
+            double z = 0;
+            for (size_t k = 0; k < W[c].size(); ++k) {
+                for (size_t j = 0; j < others.size() && k + j < G.size(); ++j) w[k] += others[j] * G[k + j];
+                z += W[c][k] * w[k];
+            }
+            if (z <= 0) return false;
+            for (size_t f = 0; f < componentCells[c].size(); ++f) {
+                double mine = 0;
+                for (size_t k = 0; k < w.size(); ++k) mine += S[c][f][k] * w[k];
+                probability[frontier_[componentCells[c][f]]] = mine / z;
+            }
+        }
+
+        // 内部格：剩余雷数的期望平均分到每个内部格
+        const std::vector<double>& all = prefix[components_];
+        double z = 0, expected = 0;
+        for (size_t m = 0; m < all.size() && m < G.size(); ++m) {
+            z += all[m] * G[m];
+            expected += all[m] * G[m] * (remaining - (int)m);
+        }
+        if (z <= 0) return false;
+        interiorProbability_ = interior > 0 ? expected / z / interior : 0;
+        for (int i = 0; i < board.rows(); ++i) {
+            for (int j = 0; j < board.cols(); ++j) {
+                int idx = board.index(i, j);
+                if ((cells[idx] & Board::STATUS_MASK) == 0 && frontierId_[idx] < 0) probability[idx] = interiorProbability_;
+            }
+        }
+        return true;
+    }
+
+    // 最近一次分析的统计
+    int frontierCells() const { return (int)frontier_.size(); }
+    int components() const { return components_; }
+    int largestComponent() const { return largest_; }
+    double interiorProbability() const { return interiorProbability_; }
+
+private:
+    struct Constraint {
+        int need = 0;
+        std::vector<int> cells; // 边界格编号；分量计算时换成分量内的位置
+    };
+
+    int find(int x) {
+        while (parent_[x] != x) x = parent_[x] = parent_[parent_[x]];
+        return x;
+    }
+    void unite(int a, int b) { parent_[find(a)] = find(b); }
+
+    // ln C(n, k)。阶乘的对数按需累加成表（不用 lgamma：它会写全局变量 signgam，多线程同时分析时不安全）
+    double logChoose(int n, int k) {
+        while ((int)logFactorial_.size() <= n) {
+            logFactorial_.push_back(logFactorial_.empty() ? 0.0 : logFactorial_.back() + std::log((double)logFactorial_.size()));
+        }
+        return logFactorial_[n] - logFactorial_[k] - logFactorial_[n - k];
+    }
+
+    // 多项式乘法，结果按最大值归一化
+    static std::vector<double> convolve(const std::vector<double>& a, const std::vector<double>& b) {
+        std::vector<double> out(a.size() + b.size() - 1, 0.0);
+        for (size_t i = 0; i < a.size(); ++i) {
+            if (a[i] == 0) continue;
+            for (size_t j = 0; j < b.size(); ++j) out[i + j] += a[i] * b[j];
+        }
+        normalize(out);
+        return out;
+    }
+    static void normalize(std::vector<double>& v) {
+        double m = *std::max_element(v.begin(), v.end());
+        if (m > 0) {
+            for (double& x : v) x /= m;
+        }
+    }
+
+    // 状态在第 i 格前后的变化：第 i+1 个边界上每个未完成约束还差的雷数从哪里来
+    struct Step {
+        std::vector<int> source;   // 在第 i 个边界状态中的位置，-1 表示在第 i 格新开始的约束
+        std::vector<int> initial;  // 新开始的约束的初始雷数
+        std::vector<char> touches; // 约束是否包含第 i 格
+        std::vector<int> capacity; // 第 i 格之后约束还剩的格子数
+        std::vector<int> closeSource; // 在第 i 格结束的约束：在第 i 个边界状态中的位置，-1 表示只有这一格
+        std::vector<int> closeInitial;
+    };
+
+    // 状态转移：第 i 格取 x（0 或 1），不合法时返回 false
+    static bool transition(const Step& s, const uint8_t* key, int x, uint8_t* next) {
+        for (size_t k = 0; k < s.closeSource.size(); ++k) {
+            int need = s.closeSource[k] >= 0 ? key[s.closeSource[k]] : s.closeInitial[k];
+            if (need != x) return false;
+        }
+        for (size_t k = 0; k < s.source.size(); ++k) {
+            int need = (s.source[k] >= 0 ? key[s.source[k]] : s.initial[k]) - (s.touches[k] ? x : 0);
+            if (need < 0 || need > s.capacity[k]) return false;
+            next[k] = (uint8_t)need;
+        }
+        return true;
+    }
+
+    // 一层（第 i 个边界）的全部状态。同一层的状态长度相同（该边界上未完成的约束数），
+    // 状态字节和解数（每个状态 width 个，按放雷数分开）都连续存放，用开放寻址哈希表查找；
+    // 各层在多次分析之间复用，稳定之后不再分配内存
+    struct Layer {
+        int width = 0;
+        int keyLength = 0;
+        int count = 0;
+        std::vector<uint8_t> keys;
+        std::vector<double> values;
+        std::vector<int> table; // 状态序号，-1 为空
+
+        void reset(int w, int length) {
+            width = w;
+            keyLength = length;
+            count = 0;
+            keys.clear();
+            values.clear();
+            table.assign(16, -1);
+        }
+        const uint8_t* key(int s) const { return keys.data() + (size_t)s * keyLength; }
+        const double* at(int s) const { return values.data() + (size_t)s * width; }
+
+        // 查找状态，不存在时返回 -1
+        int find(const uint8_t* k) const {
+            size_t mask = table.size() - 1;
+            for (size_t h = hash(k) & mask;; h = (h + 1) & mask) {
+                if (table[h] < 0 || std::equal(k, k + keyLength, key(table[h]))) return table[h];
+            }
+        }
+        // 查找或加入状态，返回它的解数
+        double* add(const uint8_t* k) {
+            size_t mask = table.size() - 1, h = hash(k) & mask;
+            while (table[h] >= 0 && !std::equal(k, k + keyLength, key(table[h]))) h = (h + 1) & mask;
+            if (table[h] < 0) {
+                table[h] = count++;
+                keys.insert(keys.end(), k, k + keyLength);
+                values.resize(values.size() + width, 0.0);
+                if (count * 2 > (int)table.size()) rehash();
+                return values.data() + values.size() - width;
+            }
+            return values.data() + (size_t)table[h] * width;
+        }
+        // 全部解数除以最大值，返回最大值的对数（没有状态时返回 0）
+        double normalize() {
+            double top = values.empty() ? 0 : *std::max_element(values.begin(), values.end());
+            if (top <= 0) return 0;
+            for (double& v : values) v /= top;
+            return std::log(top);
+        }
+
+    private:
+        size_t hash(const uint8_t* k) const {
+            uint64_t h = 0xcbf29ce484222325ULL;
+            for (int i = 0; i < keyLength; ++i) h = (h ^ k[i]) * 0x100000001b3ULL;
+            return (size_t)(h ^ (h >> 29));
+        }
+        void rehash() {
+            table.assign(table.size() * 2, -1);
+            size_t mask = table.size() - 1;
+            for (int s = 0; s < count; ++s) {
+                size_t h = hash(key(s)) & mask;
+                while (table[h] >= 0) h = (h + 1) & mask;
+                table[h] = s;
+            }
+        }
+    };
+
+    // 逐格的正向 / 反向计数，见文件开头的说明
+    bool countComponent(const std::vector<int>& cellIds, const std::vector<int>& constraintIds, std::vector<double>& W,
+                        std::vector<std::vector<double>>& S) {
+        int n = (int)cellIds.size();
+        // 广度优先排列：与当前格共享约束的格子紧随其后
+        for (int k = 0; k < n; ++k) local_[cellIds[k]] = k;
+        std::vector<std::vector<int>> cellConstraints(n);
+        for (int c : constraintIds) {
+            for (int f : constraints_[c].cells) cellConstraints[local_[f]].push_back(c);
+        }
+        std::vector<int> order, position(n, -1);
+        order.reserve(n);
+        position[0] = 0;
+        order.push_back(0);
+        for (size_t head = 0; head < order.size(); ++head) {
+            for (int c : cellConstraints[order[head]]) {
+                for (int f : constraints_[c].cells) {
+                    int l = local_[f];
+                    if (position[l] < 0) {
+                        position[l] = (int)order.size();
+                        order.push_back(l);
+                    }
+                }
+            }
+        }
+
+        // 每个约束的第一格、最后一格和格子位置
+        int m = (int)constraintIds.size();
+        std::vector<int> first(m, n), last(m, -1), need(m);
+        std::vector<std::vector<int>> positions(m);
+        for (int c = 0; c < m; ++c) {
+            need[c] = constraints_[constraintIds[c]].need;
+            for (int f : constraints_[constraintIds[c]].cells) {
+                int p = position[local_[f]];
+                positions[c].push_back(p);
+                first[c] = std::min(first[c], p);
+                last[c] = std::max(last[c], p);
+            }
+        }
+        std::vector<std::vector<int>> open(n + 1); // 第 i 个边界上未完成的约束
+        for (int c = 0; c < m; ++c) {
+            for (int i = first[c] + 1; i <= last[c]; ++i) open[i].push_back(c);
+        }
+        if ((int)steps_.size() < n) steps_.resize(n);
+        for (int i = 0; i < n; ++i) {
+            Step& s = steps_[i];
+            s.source.clear();
+            s.initial.clear();
+            s.touches.clear();
+            s.capacity.clear();
+            s.closeSource.clear();
+            s.closeInitial.clear();
+            auto indexIn = [&](int c) {
+                auto it = std::find(open[i].begin(), open[i].end(), c);
+                return it == open[i].end() ? -1 : (int)(it - open[i].begin());
+            };
+            for (int c : open[i + 1]) {
+                s.source.push_back(indexIn(c));
+                s.initial.push_back(need[c]);
+                s.touches.push_back(std::find(positions[c].begin(), positions[c].end(), i) != positions[c].end());
+                int after = 0;
+                for (int p : positions[c]) after += p > i;
+                s.capacity.push_back(after);
+            }
+            for (int c = 0; c < m; ++c) {
+                if (last[c] == i) {
+                    s.closeSource.push_back(indexIn(c));
+                    s.closeInitial.push_back(need[c]);
+                }
+            }
+        }
+
+        // 正向：forward[i] 中状态的第 k 个数 = 前 i 格放 k 个雷、到达该状态的解数
+        if ((int)forward_.size() < n + 1) {
+            forward_.resize(n + 1);
+            backward_.resize(n + 1);
+        }
+        size_t width = 1;
+        for (const auto& o : open) width = std::max(width, o.size());
+        next_.resize(width);
+        uint8_t* next = next_.data();
+        // 第 i 层的真实解数 = 保存的值 × exp(forwardLog_[i])（反向同理），只在最后合并时用到
+        forwardLog_.assign(n + 1, 0.0);
+        backwardLog_.assign(n + 1, 0.0);
+        forward_[0].reset(1, 0);
+        forward_[0].add(next)[0] = 1;
+        for (int i = 0; i < n; ++i) {
+            const Layer& from = forward_[i];
+            Layer& to = forward_[i + 1];
+            to.reset(i + 2, (int)open[i + 1].size());
+            for (int s = 0; s < from.count; ++s) {
+                const double* f = from.at(s);
+                for (int x = 0; x <= 1; ++x) {
+                    if (!transition(steps_[i], from.key(s), x, next)) continue;
+                    double* v = to.add(next);
+                    for (int k = 0; k <= i; ++k) v[k + x] += f[k];
+                }
+            }
+            if (to.count == 0) return false; // 无解
+            forwardLog_[i + 1] = forwardLog_[i] + to.normalize();
+        }
+        W.assign(forward_[n].at(0), forward_[n].at(0) + n + 1); // 已按最大值归一化
+        if (*std::max_element(W.begin(), W.end()) <= 0) return false;
+
+        // 反向：backward[i] 中状态的第 k 个数 = 从该状态出发、后 n - i 格放 k 个雷的解数，只算正向能到达的状态
+        backward_[n].reset(1, 0);
+        backward_[n].add(next)[0] = 1;
+        for (int i = n - 1; i >= 0; --i) {
+            const Layer& from = backward_[i + 1];
+            Layer& to = backward_[i];
+            to.reset(n - i + 1, (int)open[i].size());
+            for (int s = 0; s < forward_[i].count; ++s) {
+                double* v = nullptr;
+                for (int x = 0; x <= 1; ++x) {
+                    if (!transition(steps_[i], forward_[i].key(s), x, next)) continue;
+                    int t = from.find(next);
+                    if (t < 0) continue;
+                    if (!v) v = to.add(forward_[i].key(s));
+                    const double* b = from.at(t);
+                    for (int k = 0; k < n - i; ++k) v[k + x] += b[k];
+                }
+            }
+            backwardLog_[i] = backwardLog_[i + 1] + to.normalize();
+        }
+
+        // 第 i 格为雷的解数：正向到第 i 个边界 × 放雷 × 反向从第 i+1 个边界。
+        // 换算到 W 的单位：乘以 exp(forwardLog_[i] + backwardLog_[i+1] - forwardLog_[n])，
+        // 在对数中相乘，结果不超过对应的 W[k]，不会溢出
+        S.assign(n, std::vector<double>(n + 1, 0.0));
+        for (int i = 0; i < n; ++i) {
+            std::vector<double>& out = S[order[i]];
+            for (int s = 0; s < forward_[i].count; ++s) {
+                if (!transition(steps_[i], forward_[i].key(s), 1, next)) continue;
+                int t = backward_[i + 1].find(next);
+                if (t < 0) continue;
+                const double* f = forward_[i].at(s);
+                const double* b = backward_[i + 1].at(t);
+                for (int a = 0; a <= i; ++a) {
+                    if (f[a] == 0) continue;
+                    for (int k = 0; k < n - i; ++k) out[a + k + 1] += f[a] * b[k];
+                }
+            }
+            double shift = forwardLog_[i] + backwardLog_[i + 1] - forwardLog_[n];
+            for (double& x : out) {
+                if (x > 0) x = std::exp(std::log(x) + shift);
+            }
+        }
+        return true;
+    }
+
+    std::vector<int> frontierId_; // 按 Board 下标，边界格的编号，其余为 -1
+    std::vector<int> frontier_;   // 边界格的 Board 下标
+    std::vector<Constraint> constraints_;
+    std::vector<int> parent_;
+    std::vector<int> local_;      // 按边界格编号，在所属分量中的序号
+    std::vector<Step> steps_;
+    std::vector<uint8_t> next_; // 转移后的状态
+    std::vector<double> logFactorial_;
+    std::vector<Layer> forward_, backward_;
+    std::vector<double> forwardLog_, backwardLog_; // 每层缩放的对数
+    int components_ = 0;
+    int largest_ = 0;
+    double interiorProbability_ = 0;
+};
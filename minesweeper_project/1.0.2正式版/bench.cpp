@@ -0,0 +1,1214 @@
+// 性能基准测试
+// 编译：g++ -O2 -std=c++17 -pthread bench.cpp -o bench
+// 用法：bench [名称...]，不带参数时运行全部基准
+#include <iostream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <iomanip>
+#include <string>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+#include "board.h"
+#include "boardfile.h"
+#include "analyzer.h"
+#include "boardpack.h"
+#include "bot.h"
+#include "eventlog.h"
+#include "game.h"
+#include "generator.h"
+#include "metrics.h"
+#include "renderer.h"
+#include "replay.h"
+#include "solver.h"
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+static double secondsSince(Clock::time_point t0) {
+    return chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// 防止编译器把被测代码优化掉
+static volatile long long sink;
+
+// 生成固定种子的雷位置，保证两种布局测的是同一个棋盘
+static vector<pair<int, int>> randomMines(int rows, int cols, int mines, unsigned seed) {
+    mt19937 gen(seed);
+    vector<char> used((size_t)rows * cols, 0);
+    vector<pair<int, int>> result;
+    uniform_int_distribution<> distrib(0, rows * cols - 1);
+    while ((int)result.size() < mines) {
+        int pos = distrib(gen);
+        if (!used[pos]) {
+            used[pos] = 1;
+            result.push_back({pos / cols, pos % cols});
+        }
+    }
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// 1.0.2 原始布局：vector<vector<int>> + vector<vector<CellStatus>>
+struct NestedBoard {
+    int rows, cols;
+    vector<vector<int>> board;
+    vector<vector<CellStatus>> status;
+
+    void build(int r, int c, const vector<pair<int, int>>& mines) {
+        rows = r;
+        cols = c;
+        board.assign(rows, vector<int>(cols, 0));
+        status.assign(rows, vector<CellStatus>(cols, HIDDEN));
+        for (const auto& pos : mines) board[pos.first][pos.second] = -1;
+        for (int i = 0; i < rows; ++i) {
+            for (int j = 0; j < cols; ++j) {
+                if (board[i][j] == -1) continue;
+                int count = 0;
+                for (int x = -1; x <= 1; ++x) {
+                    for (int y = -1; y <= 1; ++y) {
+                        int ni = i + x, nj = j + y;
+                        if (ni >= 0 && ni < rows && nj >= 0 && nj < cols && board[ni][nj] == -1) count++;
+                    }
+                }
+                board[i][j] = count;
+            }
+        }
+    }
+
+    bool reveal(int row, int col) {
+        if (row < 0 || row >= rows || col < 0 || col >= cols || status[row][col] != HIDDEN) return true;
+        status[row][col] = REVEALED;
+        if (board[row][col] == -1) return false;
+        if (board[row][col] == 0) {
+            for (int x = -1; x <= 1; ++x)
+                for (int y = -1; y <= 1; ++y)
+                    if (x != 0 || y != 0) reveal(row + x, col + y);
+        }
+        return true;
+    }
+
+    bool checkWin() const {
+        for (int i = 0; i < rows; ++i)
+            for (int j = 0; j < cols; ++j)
+                if (board[i][j] != -1 && status[i][j] != REVEALED) return false;
+        return true;
+    }
+
+    int correctFlags() const {
+        int n = 0;
+        for (int i = 0; i < rows; ++i)
+            for (int j = 0; j < cols; ++j)
+                if (status[i][j] == FLAGGED && board[i][j] == -1) n++;
+        return n;
+    }
+};
+
+// 扁平布局：揭示与 main.cpp 中 revealCell 相同；
+// 游戏里胜负判断已改为 Board 的 O(1) 计数，这里保留整盘扫描版本用来比较布局本身
+struct FlatBoard {
+    Board board;
+    vector<int> revealed;
+
+    void build(int r, int c, const vector<pair<int, int>>& mines) {
+        board.reset(r, c);
+        for (const auto& pos : mines) board.setMine(board.index(pos.first, pos.second));
+        board.computeAdjacency();
+    }
+
+    bool reveal(int row, int col) {
+        revealed.clear();
+        return board.reveal(board.index(row, col), revealed);
+    }
+
+    // 旧的递归展开，仅用于 flood 基准对照
+    bool revealRecursive(int idx) {
+        if (board.statusAt(idx) != HIDDEN) return true;
+        board.setStatus(idx, REVEALED);
+        if (board.isMine(idx)) return false;
+        if (board.adjacent(idx) == 0) {
+            const int* nb = board.neighbours();
+            for (int k = 0; k < 8; ++k) revealRecursive(idx + nb[k]);
+        }
+        return true;
+    }
+
+    bool checkWin() const {
+        for (int i = 0; i < board.rows(); ++i) {
+            const uint8_t* row = board.row(i);
+            int hiddenSafe = 0;
+            for (int j = 0; j < board.cols(); ++j)
+                hiddenSafe += ((row[j] & Board::MINE_BIT) == 0) & ((row[j] & Board::STATUS_MASK) != Board::REVEALED_BITS);
+            if (hiddenSafe) return false;
+        }
+        return true;
+    }
+
+    int correctFlags() const {
+        int n = 0;
+        for (int i = 0; i < board.rows(); ++i) {
+            const uint8_t* row = board.row(i);
+            for (int j = 0; j < board.cols(); ++j)
+                n += (row[j] & (Board::MINE_BIT | Board::STATUS_MASK)) == (Board::MINE_BIT | Board::FLAGGED_BITS);
+        }
+        return n;
+    }
+};
+
+// 揭示全部安全格子，然后反复做整盘胜负检查（检查全部通过时是最坏情况的全盘扫描）
+template <class B>
+static void runLayout(const char* name, int rows, int cols, const vector<pair<int, int>>& mines) {
+    B b;
+    b.build(rows, cols, mines);
+    vector<char> isMine((size_t)rows * cols, 0);
+    for (const auto& pos : mines) isMine[(size_t)pos.first * cols + pos.second] = 1;
+
+    auto t0 = Clock::now();
+    for (int i = 0; i < rows; ++i)
+        for (int j = 0; j < cols; ++j)
+            if (!isMine[(size_t)i * cols + j]) b.reveal(i, j);
+    double revealSec = secondsSince(t0);
+
+    int passes = max(1, 20000000 / (rows * cols));
+    long long acc = 0;
+    t0 = Clock::now();
+    for (int p = 0; p < passes; ++p) acc += b.checkWin() + b.correctFlags();
+    double checkSec = secondsSince(t0);
+    sink = acc;
+
+    double cells = (double)rows * cols;
+    cout << "  " << left << setw(8) << name << right << fixed << setprecision(1)
+         << " 揭示 " << setw(8) << cells / revealSec / 1e6 << " M格/秒"
+         << "   检查 " << setw(8) << cells * passes / checkSec / 1e6 << " M格/秒" << endl;
+}
+
+static void benchLayout() {
+    cout << "[layout] 嵌套 vector 与扁平 Board 的揭示/胜负检查吞吐量" << endl;
+    const int sizes[] = {100, 1000, 3000};
+    for (int n : sizes) {
+        auto mines = randomMines(n, n, n * n * 15 / 100, 1234);
+        cout << n << "x" << n << " (15% 雷)" << endl;
+        runLayout<NestedBoard>("nested", n, n, mines);
+        runLayout<FlatBoard>("flat", n, n, mines);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 空白区域展开：显式队列与递归对比。稀疏棋盘上整片空白区域可达数百万格，
+// 递归版本会栈溢出，因此只在最大区域较小时运行递归对照。
+static void benchFlood() {
+    cout << "[flood] 2000x2000 棋盘逐格点击全部安全格" << endl;
+    const int n = 2000;
+    const int densities[] = {0, 1, 5, 15, 30};
+    for (int d : densities) {
+        auto mines = randomMines(n, n, n * n / 100 * d, 99);
+        FlatBoard b;
+        b.build(n, n, mines);
+        vector<int> safe;
+        for (int idx = 0; idx < (n + 2) * (n + 2); ++idx)
+            if (!b.board.isBorder(idx) && !b.board.isMine(idx)) safe.push_back(idx);
+
+        size_t largest = 0;
+        long long revealedTotal = 0;
+        auto t0 = Clock::now();
+        for (int idx : safe) {
+            b.revealed.clear();
+            b.board.reveal(idx, b.revealed);
+            largest = max(largest, b.revealed.size());
+            revealedTotal += b.revealed.size();
+        }
+        double iterSec = secondsSince(t0);
+
+        cout << "  " << setw(2) << d << "% 雷  最大区域 " << setw(8) << largest << " 格"
+             << fixed << setprecision(1) << "   队列 " << setw(7) << revealedTotal / iterSec / 1e6 << " M格/秒";
+        if (largest < 100000) {
+            FlatBoard r;
+            r.build(n, n, mines);
+            t0 = Clock::now();
+            for (int idx : safe) r.revealRecursive(idx);
+            double recSec = secondsSince(t0);
+            cout << "   递归 " << setw(7) << revealedTotal / recSec / 1e6 << " M格/秒";
+        } else {
+            cout << "   递归 跳过（栈溢出风险）";
+        }
+        cout << endl;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 差分渲染：整屏重绘与移动一次光标的输出字节数
+static void benchDiffBytes() {
+    cout << "[diff] 每帧输出字节数" << endl;
+    const int sizes[] = {20, 200, 1000};
+    for (int n : sizes) {
+        FlatBoard b;
+        b.build(n, n, randomMines(n, n, n * n * 15 / 100, 7));
+        Renderer r;
+        size_t fullBytes = r.compose(b.board, false, 0, 0, 0).size();
+        size_t moveBytes = r.compose(b.board, false, 0, 0, 1).size();
+        b.reveal(n / 2, n / 2);
+        size_t revealBytes = r.compose(b.board, false, 0, 0, 1).size();
+        cout << "  " << setw(4) << n << "x" << left << setw(5) << n << right
+             << " 整屏 " << setw(9) << fullBytes << " 字节   光标移动 " << setw(4) << moveBytes
+             << " 字节   揭示 " << b.revealed.size() << " 格 " << revealBytes << " 字节" << endl;
+    }
+}
+
+// 1.0.2 原始 printBoard 的写法（去掉 system("cls")）：每格单独输出颜色和复位，每行 endl 刷新
+static void legacyPrint(ostream& out, const Board& board, int cursorRow, int cursorCol) {
+    int rows = board.rows(), cols = board.cols();
+    out << COLOR_TIME << "用时：" << fixed << setprecision(0) << 0.0 << " 秒" << COLOR_RESET << endl;
+    int colWidth = to_string(cols - 1).length() + 1;
+    out << "   ";
+    for (int j = 0; j < cols; ++j) out << setw(colWidth) << j;
+    out << endl;
+    out << " +" << setfill('-') << setw(colWidth * cols) << "+" << setfill(' ') << endl;
+    for (int i = 0; i < rows; ++i) {
+        out << setw(2) << i << "|";
+        for (int j = 0; j < cols; ++j) {
+            out << ((i == cursorRow && j == cursorCol) ? "[" : " ");
+            int idx = board.index(i, j);
+            CellStatus st = board.statusAt(idx);
+            if (st == REVEALED) {
+                if (board.isMine(idx)) out << COLOR_MINE << "*" << COLOR_RESET;
+                else if (board.adjacent(idx) == 0) out << COLOR_REVEALED << " " << COLOR_RESET;
+                else out << COLOR_REVEALED << board.adjacent(idx) << COLOR_RESET;
+            } else if (st == FLAGGED) {
+                out << COLOR_FLAGGED << "F" << COLOR_RESET;
+            } else {
+                out << COLOR_HIDDEN << "." << COLOR_RESET;
+            }
+            out << ((i == cursorRow && j == cursorCol) ? "]" : " ");
+        }
+        out << "|" << endl;
+    }
+    out << " +" << setfill('-') << setw(colWidth * cols) << "+" << setfill(' ') << endl;
+}
+
+#ifdef _WIN32
+static const char* NULL_DEVICE = "NUL";
+#else
+static const char* NULL_DEVICE = "/dev/null";
+#endif
+
+// 整屏重绘的帧率：原始逐格 cout 写法与单缓冲区拼帧对比，输出写到空设备
+static void benchFrames() {
+    cout << "[frames] 整屏重绘帧率（半数格子已揭示）" << endl;
+    ofstream legacyOut(NULL_DEVICE);
+    FILE* nullFile = fopen(NULL_DEVICE, "wb");
+    const int sizes[] = {20, 200, 1000};
+    for (int n : sizes) {
+        FlatBoard b;
+        b.build(n, n, randomMines(n, n, n * n * 15 / 100, 11));
+        for (int i = 0; i < n / 2; ++i)
+            for (int j = 0; j < n; ++j) b.reveal(i, j);
+
+        int frames = max(3, 4000000 / (n * n));
+        auto t0 = Clock::now();
+        for (int f = 0; f < frames; ++f) legacyPrint(legacyOut, b.board, f % n, 0);
+        double legacySec = secondsSince(t0);
+
+        Renderer r;
+        size_t bytes = 0;
+        t0 = Clock::now();
+        for (int f = 0; f < frames; ++f) {
+            r.invalidate(); // 每帧都整屏重绘
+            const FrameBuffer& out = r.compose(b.board, false, 0, f % n, 0);
+            fwrite(out.data(), 1, out.size(), nullFile);
+            bytes = out.size();
+        }
+        fflush(nullFile);
+        double bufferSec = secondsSince(t0);
+
+        cout << "  " << setw(4) << n << "x" << left << setw(5) << n << right << fixed << setprecision(1)
+             << " cout " << setw(9) << frames / legacySec << " 帧/秒   缓冲区 " << setw(9) << frames / bufferSec
+             << " 帧/秒   每帧 " << bytes << " 字节" << endl;
+    }
+    fclose(nullFile);
+}
+
+// ---------------------------------------------------------------------------
+// 布雷：1.0.2 原来的逐个随机 + 碰撞重试，与 Floyd 抽样（高密度时抽取补集）对比
+static uint32_t rejectionPlace(uint32_t cells, uint32_t mines, mt19937& gen) {
+    MineBitmap bits((cells + 63) / 64, 0);
+    uint32_t draws = 0;
+    for (uint32_t i = 0; i < mines; ++i) {
+        while (true) {
+            uint32_t pos = randomBelow(gen, cells);
+            draws++;
+            if (!testBit(bits, pos)) {
+                setBit(bits, pos);
+                break;
+            }
+        }
+    }
+    return draws;
+}
+
+static void benchPlacement() {
+    cout << "[place] 布雷耗时（毫秒），密度 15%-85%" << endl;
+    const uint32_t sizes[] = {10000, 1000000, 100000000};
+    const int densities[] = {15, 30, 50, 70, 85};
+    mt19937 gen(42);
+    for (uint32_t cells : sizes) {
+        cout << "  " << cells << " 格" << endl;
+        for (int d : densities) {
+            uint32_t mines = (uint32_t)((uint64_t)cells * d / 100);
+            int reps = max(1, (int)(2000000 / cells));
+            auto t0 = Clock::now();
+            uint64_t check = 0;
+            for (int r = 0; r < reps; ++r) check += placeMines(cells, mines, gen)[0];
+            double floydMs = secondsSince(t0) * 1000 / reps;
+            sink = (long long)check;
+            cout << "    " << setw(2) << d << "%  Floyd " << fixed << setprecision(3) << setw(10) << floydMs;
+            if (cells <= 1000000) {
+                t0 = Clock::now();
+                uint32_t draws = 0;
+                for (int r = 0; r < reps; ++r) draws = rejectionPlace(cells, mines, gen);
+                double rejectMs = secondsSince(t0) * 1000 / reps;
+                cout << "   重试法 " << setw(10) << rejectMs << "（随机数 " << setprecision(2)
+                     << (double)draws / mines << " 次/雷）";
+            }
+            cout << endl;
+        }
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 周围雷数计算：原来的 9 次带越界检查探测、带边框的 8 次探测、从雷位置散射 +1、可分离滑动求和
+static void adjacencyProbe9(vector<vector<int>>& board, int rows, int cols) {
+    for (int i = 0; i < rows; ++i) {
+        for (int j = 0; j < cols; ++j) {
+            if (board[i][j] == -1) continue;
+            int count = 0;
+            for (int x = -1; x <= 1; ++x)
+                for (int y = -1; y <= 1; ++y) {
+                    int ni = i + x, nj = j + y;
+                    if (ni >= 0 && ni < rows && nj >= 0 && nj < cols && board[ni][nj] == -1) count++;
+                }
+            board[i][j] = count;
+        }
+    }
+}
+
+static void adjacencyProbe8(Board& b) {
+    const int* nb = b.neighbours();
+    for (int i = 0; i < b.rows(); ++i)
+        for (int j = 0; j < b.cols(); ++j) {
+            int idx = b.index(i, j);
+            if (b.isMine(idx)) continue;
+            int count = 0;
+            for (int k = 0; k < 8; ++k) count += b.isMine(idx + nb[k]);
+            b.setAdjacent(idx, count);
+        }
+}
+
+static void adjacencyScatter(Board& b, const vector<int>& mineIdx) {
+    uint8_t* cells = b.data();
+    const int* nb = b.neighbours();
+    for (int i = 0; i < b.rows(); ++i)
+        for (int j = 0; j < b.cols(); ++j) cells[b.index(i, j)] &= 0xF0;
+    for (int idx : mineIdx)
+        for (int k = 0; k < 8; ++k) cells[idx + nb[k]]++; // 边框格子也会被加，但不会被读取
+    for (int idx : mineIdx) cells[idx] &= 0xF0;
+}
+
+static void benchAdjacency() {
+    cout << "[adjacency] 周围雷数计算（毫秒）" << endl;
+    const int sizes[] = {1000, 4000};
+    const int densities[] = {15, 50, 85};
+    for (int n : sizes) {
+        for (int d : densities) {
+            mt19937 gen(3);
+            auto mines = bitmapToPositions(placeMines(n * n, (uint32_t)((uint64_t)n * n * d / 100), gen), n);
+
+            vector<vector<int>> nested(n, vector<int>(n, 0));
+            for (const auto& p : mines) nested[p.first][p.second] = -1;
+            Board a, b, s;
+            a.reset(n, n);
+            vector<int> mineIdx;
+            for (const auto& p : mines) {
+                a.setMine(a.index(p.first, p.second));
+                mineIdx.push_back(a.index(p.first, p.second));
+            }
+            b = a;
+            s = a;
+
+            auto t0 = Clock::now();
+            adjacencyProbe9(nested, n, n);
+            double probe9 = secondsSince(t0) * 1000;
+            t0 = Clock::now();
+            adjacencyProbe8(a);
+            double probe8 = secondsSince(t0) * 1000;
+            t0 = Clock::now();
+            adjacencyScatter(s, mineIdx);
+            double scatter = secondsSince(t0) * 1000;
+            t0 = Clock::now();
+            computeAdjacencyScalar(b.data(), n, n, b.stride());
+            double separable = secondsSince(t0) * 1000;
+
+            bool same = true;
+            for (int i = 0; i < n; ++i)
+                for (int j = 0; j < n; ++j) {
+                    int idx = b.index(i, j);
+                    int expect = nested[i][j] == -1 ? 0 : nested[i][j];
+                    same &= b.adjacent(idx) == expect && a.adjacent(idx) == expect && s.adjacent(idx) == expect;
+                }
+
+            cout << "  " << n << "x" << n << " " << setw(2) << d << "%" << fixed << setprecision(2)
+                 << "  9 次探测 " << setw(8) << probe9 << "  8 次探测 " << setw(8) << probe8
+                 << "  散射 " << setw(8) << scatter << "  滑动求和 " << setw(8) << separable
+                 << (same ? "" : "  结果不一致！") << endl;
+        }
+    }
+}
+
+// SIMD 内核：先在各种尺寸（含不足一个向量宽度的列数和尾部）上逐字节对比标量结果，再测 4096x4096 的吞吐量
+static void benchSimd() {
+    const AdjacencyKernel kernels[] = {ADJACENCY_SCALAR, ADJACENCY_SSE2, ADJACENCY_AVX2};
+    cout << "[simd] 周围雷数 SIMD 内核（运行时选择：" << adjacencyKernelName(bestAdjacencyKernel()) << "）" << endl;
+
+    mt19937 gen(11);
+    bool allSame = true;
+    const int shapes[][2] = {{1, 1}, {1, 40}, {40, 1}, {3, 15}, {7, 16}, {9, 17}, {16, 31}, {16, 32}, {5, 33}, {30, 63}, {24, 100}, {101, 257}};
+    for (const auto& shape : shapes) {
+        for (int d : {0, 15, 50, 85, 100}) {
+            int rows = shape[0], cols = shape[1];
+            Board ref;
+            ref.reset(rows, cols);
+            for (const auto& p : bitmapToPositions(placeMines(rows * cols, (uint32_t)(rows * cols * d / 100), gen), cols)) {
+                ref.setMine(ref.index(p.first, p.second));
+            }
+            Board base = ref;
+            computeAdjacencyScalar(ref.data(), rows, cols, ref.stride());
+            size_t bytes = (size_t)(rows + 2) * ref.stride();
+            for (AdjacencyKernel k : kernels) {
+                if (!adjacencyKernelSupported(k)) continue;
+                Board b = base;
+                computeAdjacencyWith(k, b.data(), rows, cols, b.stride());
+                if (memcmp(b.data(), ref.data(), bytes) != 0) {
+                    cout << "  " << adjacencyKernelName(k) << " 与标量结果不一致：" << rows << "x" << cols << " " << d << "%" << endl;
+                    allSame = false;
+                }
+            }
+        }
+    }
+    cout << "  正确性校验" << (allSame ? "通过" : "失败") << endl;
+
+    const int n = 4096;
+    const int reps = 5;
+    for (int d : {15, 50, 85}) {
+        Board base;
+        base.reset(n, n);
+        for (const auto& p : bitmapToPositions(placeMines(n * n, (uint32_t)((uint64_t)n * n * d / 100), gen), n)) {
+            base.setMine(base.index(p.first, p.second));
+        }
+        Board ref = base;
+        computeAdjacencyScalar(ref.data(), n, n, ref.stride());
+        size_t bytes = (size_t)(n + 2) * base.stride();
+
+        cout << "  " << n << "x" << n << " " << setw(2) << d << "%";
+        for (AdjacencyKernel k : kernels) {
+            if (!adjacencyKernelSupported(k)) continue;
+            Board b = base;
+            auto t0 = Clock::now();
+            for (int r = 0; r < reps; ++r) computeAdjacencyWith(k, b.data(), n, n, b.stride());
+            double ms = secondsSince(t0) * 1000 / reps;
+            bool same = memcmp(b.data(), ref.data(), bytes) == 0;
+            cout << "  " << adjacencyKernelName(k) << " " << fixed << setprecision(2) << setw(7) << ms << " 毫秒 "
+                 << setprecision(1) << setw(5) << bytes / (ms / 1000) / 1e9 << " GB/s" << (same ? "" : "（结果不一致！）");
+        }
+        cout << endl;
+    }
+}
+
+// .sl 文件读写：旧版文本格式与第 2 版二进制内存映射格式
+static long long fileSize(const string& path) {
+    ifstream f(path, ios::binary | ios::ate);
+    return f ? (long long)f.tellg() : -1;
+}
+
+static void benchFileIO() {
+    cout << "[fileio] .sl 文件保存/加载（毫秒）" << endl;
+    const string textPath = "bench_text.sl";
+    const string binPath = "bench_binary.sl";
+    const int sizes[] = {100, 1000, 4096};
+    for (int n : sizes) {
+        for (int d : {15, 50}) {
+            mt19937 gen(5);
+            BoardLayout layout;
+            layout.rows = layout.cols = n;
+            layout.mines = (int)((int64_t)n * n * d / 100);
+            layout.seed = 5;
+            layout.bits = placeMines(n * n, layout.mines, gen);
+            string error;
+            int reps = n <= 100 ? 200 : n <= 1000 ? 5 : 1;
+
+            auto t0 = Clock::now();
+            for (int r = 0; r < reps; ++r) saveBoardText(textPath, layout, error);
+            double textSave = secondsSince(t0) * 1000 / reps;
+            BoardLayout fromText;
+            t0 = Clock::now();
+            for (int r = 0; r < reps; ++r) loadBoardFile(textPath, fromText, error);
+            double textLoad = secondsSince(t0) * 1000 / reps;
+
+            t0 = Clock::now();
+            for (int r = 0; r < reps; ++r) saveBoardBinary(binPath, layout, error);
+            double binSave = secondsSince(t0) * 1000 / reps;
+            BoardLayout fromBin;
+            t0 = Clock::now();
+            for (int r = 0; r < reps; ++r) loadBoardFile(binPath, fromBin, error);
+            double binLoad = secondsSince(t0) * 1000 / reps;
+
+            bool same = fromText.bits == layout.bits && fromBin.bits == layout.bits && fromBin.seed == layout.seed &&
+                        fromText.mines == layout.mines && fromBin.mines == layout.mines;
+            cout << "  " << setw(4) << n << "x" << setw(4) << left << n << right << " " << d << "%" << fixed << setprecision(2)
+                 << "  文本 " << setw(9) << fileSize(textPath) / 1024 << " KB 保存 " << setw(8) << textSave << " 加载 " << setw(8) << textLoad
+                 << "  二进制 " << setw(7) << fileSize(binPath) / 1024 << " KB 保存 " << setw(6) << binSave << " 加载 " << setw(6) << binLoad
+                 << (same ? "" : "  结果不一致！") << endl;
+        }
+    }
+
+    // 损坏的文件必须被拒绝
+    {
+        fstream f(binPath, ios::in | ios::out | ios::binary);
+        f.seekp(sizeof(SlHeader) + 10);
+        f.put((char)0x5A);
+    }
+    BoardLayout broken;
+    string error;
+    cout << "  损坏文件检测：" << (loadBoardFile(binPath, broken, error) ? "未检出！" : error) << endl;
+    remove(textPath.c_str());
+    remove(binPath.c_str());
+}
+
+// 压缩编码：不同雷密度下三种格式的文件大小和 Rice 编码/解码速度
+static void benchArchive() {
+    cout << "[archive] .sl 压缩编码（大小 KB，时间毫秒）" << endl;
+    const string textPath = "bench_text.sl";
+    const string ricePath = "bench_rice.sl";
+    for (int n : {1000, 4096}) {
+        for (int d : {1, 5, 15, 30, 50, 85}) {
+            mt19937 gen(9);
+            BoardLayout layout;
+            layout.rows = layout.cols = n;
+            layout.mines = (int)((int64_t)n * n * d / 100);
+            layout.bits = placeMines(n * n, layout.mines, gen);
+            string error;
+
+            saveBoardText(textPath, layout, error);
+            auto t0 = Clock::now();
+            saveBoardBinary(ricePath, layout, error, SL_ENCODING_RICE);
+            double encodeMs = secondsSince(t0) * 1000;
+            BoardLayout loaded;
+            t0 = Clock::now();
+            bool ok = loadBoardFile(ricePath, loaded, error);
+            double decodeMs = secondsSince(t0) * 1000;
+            ok = ok && loaded.bits == layout.bits && loaded.mines == layout.mines;
+
+            long long textSize = fileSize(textPath);
+            long long riceSize = fileSize(ricePath);
+            long long bitmapSize = (long long)(sizeof(SlHeader) + layout.bits.size() * sizeof(uint64_t));
+            cout << "  " << setw(4) << n << "x" << setw(4) << left << n << right << " " << setw(2) << d << "%" << fixed << setprecision(1)
+                 << "  文本 " << setw(8) << textSize / 1024.0 << "  位图 " << setw(7) << bitmapSize / 1024.0
+                 << "  Rice " << setw(7) << riceSize / 1024.0 << "（文本的 1/" << setw(5) << (double)textSize / riceSize << "）"
+                 << setprecision(2) << "  编码 " << setw(6) << encodeMs << "  解码 " << setw(6) << decodeMs
+                 << "  自动选择 " << (smallestEncoding(layout) == SL_ENCODING_RICE ? "Rice" : "位图")
+                 << (ok ? "" : "  结果不一致！") << endl;
+        }
+    }
+    remove(textPath.c_str());
+    remove(ricePath.c_str());
+}
+
+// 对局快照：随机走到一半的对局，保存后重新加载恢复，逐字节比较棋盘
+static void benchSnapshot() {
+    cout << "[snapshot] 对局快照保存/恢复（微秒）" << endl;
+    const string path = "bench_snapshot.sl";
+    const int sizes[][3] = {{10, 10, 15}, {20, 20, 35}, {100, 100, 1500}, {1000, 1000, 150000}, {4096, 4096, 2516582}};
+    for (const auto& s : sizes) {
+        int rows = s[0], cols = s[1], mines = s[2];
+        mt19937 gen(21);
+        Game game;
+        game.create(rows, cols, bitmapToPositions(placeMines(rows * cols, mines, gen), cols));
+        // 揭示约一半的安全格，标记约一半的雷
+        for (int i = 0; i < rows; ++i)
+            for (int j = 0; j < cols; ++j) {
+                int idx = game.board().index(i, j);
+                if (gen() % 2 == 0) continue;
+                if (game.board().isMine(idx)) game.toggleFlag(i, j);
+                else if (game.board().hiddenSafe() > 1) game.reveal(i, j);
+            }
+        BoardLayout layout = layoutFromPositions(rows, cols, game.minePositions());
+        SnapshotInfo info;
+        info.cursorRow = rows / 2;
+        info.cursorCol = cols / 3;
+        info.elapsedMs = 123456;
+        info.firstMove = false;
+        string error;
+        int reps = rows <= 100 ? 1000 : rows <= 1000 ? 10 : 2;
+
+        auto t0 = Clock::now();
+        for (int r = 0; r < reps; ++r) saveGameSnapshot(path, layout, game.board(), info, error, smallestEncoding(layout));
+        double saveUs = secondsSince(t0) * 1e6 / reps;
+
+        Game restored;
+        BoardLayout loaded;
+        bool ok = true;
+        t0 = Clock::now();
+        for (int r = 0; r < reps; ++r) {
+            ok &= loadBoardFile(path, loaded, error) && loaded.hasSnapshot;
+            restored.create(loaded.rows, loaded.cols, loaded.positions());
+            ok &= restored.restoreStatus(loaded.statusPlanes, loaded.statusWords);
+        }
+        double loadUs = secondsSince(t0) * 1e6 / reps;
+
+        size_t bytes = (size_t)(rows + 2) * (cols + 2);
+        BoardStats a = game.stats(), b = restored.stats();
+        ok = ok && memcmp(game.board().data(), restored.board().data(), bytes) == 0 && a.flags == b.flags &&
+             a.hiddenSafe == b.hiddenSafe && a.correctFlags == b.correctFlags && loaded.snapshot.cursorRow == info.cursorRow &&
+             loaded.snapshot.cursorCol == info.cursorCol && loaded.snapshot.elapsedMs == info.elapsedMs && !loaded.snapshot.firstMove;
+        cout << "  " << setw(4) << rows << "x" << setw(4) << left << cols << right << fixed << setprecision(1)
+             << "  文件 " << setw(9) << fileSize(path) / 1024.0 << " KB  保存 " << setw(10) << saveUs << "  加载并恢复 " << setw(10) << loadUs
+             << (ok ? "" : "  结果不一致！") << endl;
+    }
+    remove(path.c_str());
+}
+
+// 种子生成：CounterRng 与 mt19937 的放雷速度，同一种子重新生成的一致性，以及只记录种子的 .sl 大小
+static void benchSeed() {
+    cout << "[seed] 按种子生成布局（微秒/局）" << endl;
+    const string path = "bench_seed.sl";
+    const int sizes[][3] = {{10, 10, 15}, {15, 15, 25}, {20, 20, 35}, {1000, 1000, 150000}, {4096, 4096, 2516582}};
+    for (const auto& s : sizes) {
+        uint32_t cells = (uint32_t)(s[0] * s[1]);
+        uint32_t mines = (uint32_t)s[2];
+        int reps = cells <= 400 ? 100000 : cells <= 1000000 ? 20 : 2;
+
+        uint64_t checksum = 0;
+        auto t0 = Clock::now();
+        for (int r = 0; r < reps; ++r) {
+            mt19937 gen(r + 1);
+            checksum += placeMines(cells, mines, gen)[0];
+        }
+        double mtUs = secondsSince(t0) * 1e6 / reps;
+        t0 = Clock::now();
+        for (int r = 0; r < reps; ++r) checksum += generateMines(cells, mines, (uint64_t)r + 1)[0];
+        double counterUs = secondsSince(t0) * 1e6 / reps;
+        sink += (long long)checksum;
+
+        BoardLayout layout;
+        layout.rows = s[0];
+        layout.cols = s[1];
+        layout.mines = s[2];
+        layout.seed = 0x123456789ABCDEFULL;
+        layout.bits = generateMines(cells, mines, layout.seed);
+        string error;
+        SlEncoding encoding = smallestEncoding(layout);
+        saveBoardBinary(path, layout, error, encoding);
+        BoardLayout loaded;
+        bool ok = loadBoardFile(path, loaded, error) && loaded.bits == layout.bits && encoding == SL_ENCODING_SEED;
+        cout << "  " << setw(4) << s[0] << "x" << setw(4) << left << s[1] << right << fixed << setprecision(2)
+             << "  mt19937 " << setw(10) << mtUs << "  CounterRng " << setw(10) << counterUs
+             << "  .sl " << fileSize(path) << " 字节（Rice " << riceEncodedSize(layout.bits, cells, mines) + sizeof(SlHeader) << " 字节）"
+             << (ok ? "" : "  重新生成的布局不一致！") << endl;
+    }
+    remove(path.c_str());
+}
+
+// 事件日志：旧版每次按键 ofstream << ... << endl（每行一次刷新）与缓冲的二进制事件日志对比
+static void benchEventLog() {
+    cout << "[eventlog] 每个事件的记录开销" << endl;
+    const string textPath = "bench_log.txt";
+    const string binPath = "bench_log.bin";
+    const int events = 200000;
+    remove(textPath.c_str());
+    remove(binPath.c_str());
+
+    auto t0 = Clock::now();
+    {
+        ofstream logFile(textPath, ios::app);
+        for (int i = 0; i < events; ++i) {
+            if (i % 4 == 3) logFile << "Input: Reveal at: " << (i % 30) << " " << (i % 16) << endl;
+            else logFile << "Input: Right" << endl;
+        }
+    }
+    double textNs = secondsSince(t0) * 1e9 / events;
+
+    t0 = Clock::now();
+    {
+        EventLog log;
+        log.open(binPath);
+        for (int i = 0; i < events; ++i) {
+            if (i % 4 == 3) log.reveal(i % 30, i % 16);
+            else log.move(EV_MOVE_RIGHT);
+        }
+    }
+    double binNs = secondsSince(t0) * 1e9 / events;
+
+    // 转回文本，检查与旧格式逐行一致
+    MappedFile file;
+    file.open(binPath);
+    EventReader reader(file.data(), file.size());
+    LogEvent e;
+    string text;
+    t0 = Clock::now();
+    while (reader.next(e)) text += eventText(e);
+    double decodeNs = secondsSince(t0) * 1e9 / events;
+    ifstream in(textPath, ios::binary);
+    string expected((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+
+    cout << fixed << setprecision(1)
+         << "  ofstream+endl " << setw(8) << textNs << " ns/事件  " << setprecision(2) << (double)fileSize(textPath) / events << " 字节/事件" << endl
+         << setprecision(1)
+         << "  二进制缓冲    " << setw(8) << binNs << " ns/事件  " << setprecision(2) << (double)fileSize(binPath) / events << " 字节/事件" << endl
+         << setprecision(1)
+         << "  转回文本      " << setw(8) << decodeNs << " ns/事件  " << (text == expected ? "与文本日志一致" : "与文本日志不一致！") << endl;
+    file.close();
+    remove(textPath.c_str());
+    remove(binPath.c_str());
+}
+
+// 回放：先用模拟玩家生成一批对局的事件日志，再无画面地重新执行，核对结果并统计每秒操作数。
+// 对局轮流使用立即生成、延迟生成和无猜布局，其中一部分在开局前保存（布局按种子确定），
+// 一部分中途保存快照、随后从快照继续，覆盖日志中的全部事件类型
+static void benchReplay() {
+    cout << "[replay] 回放事件日志" << endl;
+    const string path = "bench_replay.bin";
+    const int sizes[][4] = {{9, 9, 10, 20000}, {16, 16, 40, 10000}, {16, 30, 99, 5000}, {100, 100, 1500, 200}};
+    for (const auto& s : sizes) {
+        remove(path.c_str());
+        int rows = s[0], cols = s[1], mines = s[2], games = s[3];
+        mt19937 gen(rows * 1000 + cols);
+        long long actions = 0, chords = 0, logged = 0;
+        vector<string> snapshots;
+        {
+            EventLog log;
+            log.open(path);
+            Game game;
+            // 模拟玩家走一步：随机选格子，是雷时大多改为标记，偶尔踩雷，这样对局既有输也有赢；
+            // 选到已揭示的格子时有时双击（旗总是插对的，双击不会踩雷）
+            auto step = [&]() {
+                int r = (int)(gen() % rows), c = (int)(gen() % cols);
+                int idx = game.board().index(r, c);
+                bool mine = game.board().isMine(idx);
+                if (game.board().statusAt(idx) == REVEALED && gen() % 4 == 0) {
+                    log.chord(r, c);
+                    game.chord(r, c);
+                    chords++;
+                } else if (mine && gen() % 64 != 0) {
+                    if (game.board().statusAt(idx) == FLAGGED) return;
+                    log.flag(r, c);
+                    game.toggleFlag(r, c);
+                } else {
+                    log.reveal(r, c);
+                    game.reveal(r, c);
+                }
+                actions++;
+            };
+            for (int g = 0; g < games; ++g) {
+                uint64_t seed = (uint64_t)g + 1;
+                int mode = g % 3; // 0 立即生成，1 延迟生成，2 无猜
+                log.gameStart(0, rows, cols, mines, seed);
+                if (mode == 0) {
+                    game.create(rows, cols, bitmapToPositions(generateMines((uint32_t)(rows * cols), (uint32_t)mines, seed), cols));
+                } else {
+                    game.createDeferred(rows, cols, mines, seed, mode == 2);
+                    log.deferredLayout(mode == 2);
+                }
+                if (g % 16 == 1) { // 开局前保存：与游戏中一样先按种子确定布局（保存失败时文件名为空）
+                    game.generateNow();
+                    log.save("");
+                }
+                string snapshot;
+                for (int n = 0; !game.finished(); ++n) {
+                    if (g % 50 == 7 && n == 10 && !game.pending()) { // 与游戏中的 saveGameToFile 相同
+                        BoardLayout layout = layoutFromPositions(rows, cols, game.minePositions(), game.safeRow() >= 0 ? 0 : seed);
+                        SnapshotInfo info;
+                        string error;
+                        snapshot = "bench_replay_" + to_string(g) + ".sl";
+                        if (!saveGameSnapshot(snapshot, layout, game.board(), info, error, smallestEncoding(layout))) snapshot.clear();
+                        if (!snapshot.empty()) snapshots.push_back(snapshot);
+                        log.save(snapshot);
+                    }
+                    step();
+                }
+                log.gameOver(game.state() == WON, 0, boardHash(game.board()));
+                logged++;
+                if (snapshot.empty()) continue;
+
+                // 从快照继续：与游戏中加载存档相同，种子未知时日志中记录布局
+                BoardLayout layout;
+                string error;
+                if (!loadBoardFile(snapshot, layout, error)) continue;
+                game.create(layout.rows, layout.cols, layout.positions());
+                game.restoreStatus(layout.statusPlanes, layout.statusWords);
+                log.gameStart(0, rows, cols, mines, layout.seed);
+                if (layout.seed == 0) log.layout(layout.bits, rows, cols, mines);
+                log.resume(snapshot, 0);
+                while (!game.finished()) step();
+                log.gameOver(game.state() == WON, 0, boardHash(game.board()));
+                logged++;
+            }
+        }
+
+        MappedFile file;
+        file.open(path);
+        auto t0 = Clock::now();
+        EventReader reader(file.data(), file.size());
+        Replayer replayer;
+        LogEvent e;
+        while (reader.next(e)) replayer.apply(e);
+        replayer.finish();
+        double seconds = secondsSince(t0);
+        long long replayed = 0, verified = 0, won = 0;
+        for (const auto& r : replayer.results()) {
+            replayed += r.actions;
+            verified += r.verified;
+            won += r.end == REPLAY_WON;
+        }
+        cout << "  " << setw(3) << rows << "x" << setw(3) << left << cols << right << setw(5) << mines << " 雷 " << setw(6) << logged << " 局"
+             << "（胜 " << setw(5) << won << "，快照 " << setw(3) << snapshots.size() << "）  " << setw(8) << actions << " 次操作（双击 "
+             << setw(6) << chords << "）  " << fixed << setprecision(2) << setw(7) << seconds * 1000 << " 毫秒  " << setw(6)
+             << replayed / seconds / 1e6 << " 百万次/秒  " << fileSize(path) / 1024 << " KB"
+             << (verified == logged && replayed == actions ? "" : "  回放结果不一致！") << endl;
+        file.close();
+        for (const string& f : snapshots) remove(f.c_str());
+    }
+    remove(path.c_str());
+}
+
+// 双击：8 个邻居逐个调用 reveal 与一次多源 revealBatch 对比。
+// 所有雷先插旗，再按行扫描，每个数字格先揭示再双击，两种方式应得到完全相同的棋盘
+static void benchChord() {
+    cout << "[chord] 双击揭示周围格子（每次双击纳秒）" << endl;
+    const int sizes[][3] = {{16, 30, 99}, {100, 100, 1000}, {1000, 1000, 60000}};
+    for (const auto& s : sizes) {
+        int rows = s[0], cols = s[1], mines = s[2];
+        int reps = rows * cols <= 10000 ? 200 : 2;
+        double seconds[2] = {0, 0};
+        long long chords = 0;
+        uint64_t hashes[2] = {0, 0};
+        vector<int> revealed;
+        revealed.reserve((size_t)rows * cols);
+        for (int mode = 0; mode < 2; ++mode) {
+            for (int r = 0; r < reps; ++r) {
+                Board board;
+                board.reset(rows, cols);
+                MineBitmap bits = generateMines((uint32_t)(rows * cols), (uint32_t)mines, (uint64_t)r + 1);
+                for (const auto& p : bitmapToPositions(bits, cols)) {
+                    board.setMine(board.index(p.first, p.second));
+                    board.toggleFlag(board.index(p.first, p.second));
+                }
+                board.computeAdjacency();
+                const int* nb = board.neighbours();
+                auto t0 = Clock::now();
+                for (int i = 0; i < rows; ++i) {
+                    for (int j = 0; j < cols; ++j) {
+                        int idx = board.index(i, j);
+                        if (board.isMine(idx) || board.adjacent(idx) == 0) continue;
+                        revealed.clear();
+                        board.reveal(idx, revealed);
+                        int sources[8];
+                        for (int k = 0; k < 8; ++k) sources[k] = idx + nb[k];
+                        if (mode == 0) {
+                            for (int k = 0; k < 8; ++k) board.reveal(sources[k], revealed);
+                        } else {
+                            board.revealBatch(sources, 8, revealed);
+                        }
+                        chords += mode == 0;
+                    }
+                }
+                seconds[mode] += secondsSince(t0);
+                hashes[mode] += boardHash(board);
+            }
+        }
+        cout << "  " << setw(4) << rows << "x" << setw(4) << left << cols << right << fixed << setprecision(1)
+             << "  逐个揭示 " << setw(7) << seconds[0] * 1e9 / chords << "  批量揭示 " << setw(7) << seconds[1] * 1e9 / chords
+             << (hashes[0] == hashes[1] ? "" : "  结果不一致！") << endl;
+    }
+}
+
+// 第一次揭示才生成布局：开局时只分配棋盘，生成的开销移到第一次揭示，并核对 3x3 内没有雷
+static void benchFirstClick() {
+    cout << "[firstclick] 开局到可以操作、第一次揭示（微秒）" << endl;
+    const int sizes[][3] = {{10, 10, 15}, {20, 20, 35}, {16, 30, 99}, {1000, 1000, 150000}, {4096, 4096, 2516582}};
+    for (const auto& s : sizes) {
+        int rows = s[0], cols = s[1], mines = s[2];
+        int reps = rows * cols <= 1000 ? 20000 : 3;
+        double eagerUs = 0, deferredUs = 0, firstUs = 0;
+        bool ok = true;
+        for (int r = 0; r < reps; ++r) {
+            uint64_t seed = (uint64_t)r + 1;
+            Game eager;
+            auto t0 = Clock::now();
+            eager.create(rows, cols, bitmapToPositions(generateMines((uint32_t)(rows * cols), (uint32_t)mines, seed), cols));
+            eagerUs += secondsSince(t0) * 1e6;
+
+            Game game;
+            t0 = Clock::now();
+            game.createDeferred(rows, cols, mines, seed);
+            deferredUs += secondsSince(t0) * 1e6;
+            int row = (int)(seed * 7 % rows), col = (int)(seed * 13 % cols);
+            t0 = Clock::now();
+            bool safe = game.reveal(row, col);
+            firstUs += secondsSince(t0) * 1e6;
+            const Board& b = game.board();
+            ok &= safe && b.adjacent(b.index(row, col)) == 0 && b.mineCount() == mines && (int)game.minePositions().size() == mines;
+        }
+        cout << "  " << setw(4) << rows << "x" << setw(4) << left << cols << right << fixed << setprecision(2)
+             << "  立即生成 " << setw(10) << eagerUs / reps << "  延迟生成 开局 " << setw(9) << deferredUs / reps
+             << "  第一次揭示 " << setw(10) << firstUs / reps << (ok ? "" : "  第一次揭示踩雷或雷数不对！") << endl;
+    }
+}
+
+// 无猜布局：chooseDifficulty 的三个难度（外加 16x30/99 作参照）每秒生成的布局数，
+// 第一次揭示的位置随机，生成后在新棋盘上重新求解一遍核对
+static void benchNoGuess() {
+    cout << "[noguess] 无猜布局生成" << endl;
+    const int sizes[][4] = {{10, 10, 15, 3000}, {15, 15, 25, 3000}, {20, 20, 35, 3000}, {16, 30, 99, 300}};
+    for (const auto& s : sizes) {
+        int rows = s[0], cols = s[1], mines = s[2], boards = s[3];
+        long long attempts = 0;
+        int solved = 0, verified = 0;
+        double seconds = 0;
+        Solver solver;
+        vector<int> revealed;
+        for (int b = 0; b < boards; ++b) {
+            uint64_t seed = (uint64_t)b + 1;
+            int row = (int)(CounterRng::mix(seed) % rows), col = (int)(CounterRng::mix(seed + 1) % cols);
+            MineBitmap bits;
+            int used;
+            auto t0 = Clock::now();
+            bool ok = generateNoGuess(rows, cols, (uint32_t)mines, seed, row, col, bits, NO_GUESS_MAX_ATTEMPTS, &used);
+            seconds += secondsSince(t0);
+            attempts += used;
+            solved += ok;
+            if (ok) {
+                Board board;
+                board.reset(rows, cols);
+                for (const auto& p : bitmapToPositions(bits, cols)) board.setMine(board.index(p.first, p.second));
+                board.computeAdjacency();
+                revealed.clear();
+                verified += board.reveal(board.index(row, col), revealed) && solver.solve(board) && board.stats().correctFlags == board.stats().flags;
+            }
+        }
+        cout << "  " << setw(3) << rows << "x" << setw(3) << left << cols << right << setw(4) << mines << " 雷  "
+             << fixed << setprecision(0) << setw(8) << boards / seconds << " 局/秒  平均尝试 " << setprecision(2) << setw(6) << (double)attempts / boards
+             << "  成功 " << solved << "/" << boards << (verified == solved ? "" : "  重新求解失败！") << endl;
+    }
+}
+
+// 布局包：不同线程数生成同一主种子的布局包，文件应逐字节相同
+static void benchBatch() {
+    unsigned hardware = max(1u, thread::hardware_concurrency());
+    cout << "[batch] 并行生成布局包（硬件线程 " << hardware << "）" << endl;
+    const string path = "bench_pack.slp";
+    struct Case {
+        int rows, cols, mines;
+        bool noGuess;
+        uint64_t count;
+    };
+    const Case cases[] = {{16, 30, 99, false, 200000}, {20, 20, 35, true, 20000}, {16, 30, 99, true, 1000}};
+    vector<int> threadCounts = {1, 2, 4};
+    if (hardware > 4) threadCounts.push_back((int)hardware);
+    for (const auto& c : cases) {
+        uint64_t expected = 0;
+        for (int threads : threadCounts) {
+            PackOptions o;
+            o.rows = c.rows;
+            o.cols = c.cols;
+            o.mines = c.mines;
+            o.noGuess = c.noGuess;
+            o.count = c.count;
+            o.masterSeed = 0x5EED;
+            o.threads = threads;
+            PackStats stats;
+            string error;
+            auto t0 = Clock::now();
+            bool ok = writeBoardPack(path, o, stats, error);
+            double seconds = secondsSince(t0);
+            PackReader reader;
+            ok = ok && reader.open(path, error);
+            uint64_t checksum = ok ? reader.header().checksum : 0;
+            if (threads == threadCounts[0]) expected = checksum;
+            cout << "  " << setw(3) << c.rows << "x" << setw(3) << left << c.cols << right << setw(4) << c.mines << " 雷"
+                 << (c.noGuess ? " 无猜" : "     ") << setw(3) << threads << " 线程  " << fixed << setprecision(0) << setw(9)
+                 << c.count / seconds << " 个/秒  " << stats.bytes / 1024 << " KB"
+                 << (ok && checksum == expected ? "" : "  与单线程结果不同！") << endl;
+        }
+    }
+    remove(path.c_str());
+}
+
+// 雷概率分析：从中心开始让 Solver 推理到需要猜为止，对这时的局面计算概率。
+// 核对：概率为 0 / 1 的格子与真实布局一致，所有概率之和加旗数等于雷数；并统计最安全格子的实际踩雷率
+static void benchProbability() {
+    cout << "[probability] 雷概率分析（Solver 推理到需要猜的局面）" << endl;
+    const int sizes[][4] = {{10, 10, 15, 3000}, {15, 15, 25, 3000}, {20, 20, 35, 3000}, {16, 30, 99, 3000}};
+    for (const auto& s : sizes) {
+        int rows = s[0], cols = s[1], mines = s[2], boards = s[3];
+        Solver solver;
+        ProbabilityAnalyzer analyzer;
+        vector<int> revealed;
+        vector<double> probability, times;
+        int wrong = 0, safestMines = 0;
+        long long frontier = 0;
+        int largest = 0;
+        double safestSum = 0;
+        for (int b = 0; b < boards; ++b) {
+            MineBitmap bits = generateMinesAvoiding(rows, cols, (uint32_t)mines, (uint64_t)b + 1, rows / 2, cols / 2);
+            Board board;
+            board.reset(rows, cols);
+            for (const auto& p : bitmapToPositions(bits, cols)) board.setMine(board.index(p.first, p.second));
+            board.computeAdjacency();
+            revealed.clear();
+            board.reveal(board.index(rows / 2, cols / 2), revealed);
+            if (solver.solve(board)) continue;
+            auto t0 = Clock::now();
+            bool ok = analyzer.analyze(board, probability);
+            times.push_back(secondsSince(t0) * 1000);
+            frontier += analyzer.frontierCells();
+            largest = max(largest, analyzer.largestComponent());
+            double sum = board.stats().flags, safest = 2;
+            int safestIdx = -1;
+            for (int i = 0; i < rows; ++i) {
+                for (int j = 0; j < cols; ++j) {
+                    int idx = board.index(i, j);
+                    double p = probability[idx];
+                    if (p < 0) continue;
+                    sum += p;
+                    if ((p < 1e-9 && board.isMine(idx)) || (p > 1 - 1e-9 && !board.isMine(idx))) ok = false;
+                    if (p < safest) {
+                        safest = p;
+                        safestIdx = idx;
+                    }
+                }
+            }
+            wrong += !ok || fabs(sum - mines) > 1e-6;
+            safestSum += safest;
+            safestMines += board.isMine(safestIdx);
+        }
+        int n = (int)times.size();
+        if (n == 0) continue;
+        sort(times.begin(), times.end());
+        double total = 0;
+        for (double t : times) total += t;
+        cout << "  " << setw(3) << rows << "x" << setw(3) << left << cols << right << setw(4) << mines << " 雷  局面 " << setw(5) << n
+             << fixed << setprecision(3) << "  平均 " << total / n << " 毫秒  p99 " << times[n * 99 / 100] << "  最慢 " << times[n - 1]
+             << " 毫秒  平均边界 " << setprecision(1) << (double)frontier / n << " 格  最大分量 " << largest << " 格" << endl;
+        cout << "      最安全格子：预测踩雷率 " << setprecision(2) << safestSum / n * 100 << "%，实际 " << (double)safestMines / n * 100 << "%"
+             << (wrong ? "  概率与布局不符：" + to_string(wrong) + " 个局面！" : "") << endl;
+    }
+}
+
+// 自动玩家：按难度下满整局（第一次揭示中心，推理不了时按概率猜），完整的负载测试见 bottool
+static void benchBot() {
+    cout << "[bot] 自动玩家整局" << endl;
+    const int sizes[][4] = {{10, 10, 15, 5000}, {15, 15, 25, 5000}, {20, 20, 35, 5000}, {16, 30, 99, 1000}};
+    for (const auto& s : sizes) {
+        int rows = s[0], cols = s[1], mines = s[2], games = s[3];
+        Game game;
+        Bot bot;
+        CounterRng seeds(1);
+        int wins = 0;
+        long long moves = 0;
+        auto t0 = Clock::now();
+        for (int i = 0; i < games; ++i) {
+            game.createDeferred(rows, cols, mines, seeds.at((uint64_t)i));
+            bot.reset();
+            wins += bot.play(game) == WON;
+            moves += bot.moves();
+        }
+        double seconds = secondsSince(t0);
+        cout << "  " << setw(3) << rows << "x" << setw(3) << left << cols << right << setw(4) << mines << " 雷  " << fixed << setprecision(0)
+             << setw(7) << games / seconds << " 局/秒  " << setprecision(3) << setw(6) << seconds * 1e6 / moves << " 微秒/步  胜率 "
+             << setprecision(2) << 100.0 * wins / games << "%" << endl;
+    }
+}
+
+// 布局指标：每个布局算一次 3BV、开局区域、孤岛和 ZiNi 的用时，与计算周围雷数的用时对比，
+// 以及各难度的平均指标
+static void benchMetrics() {
+    cout << "[metrics] 布局指标（微秒/布局）" << endl;
+    const int sizes[][4] = {{10, 10, 15, 20000}, {15, 15, 25, 20000}, {20, 20, 35, 10000}, {16, 30, 99, 10000}, {1000, 1000, 150000, 3}};
+    for (const auto& s : sizes) {
+        int rows = s[0], cols = s[1], mines = s[2], reps = s[3];
+        double adjacencyUs = 0, metricsUs = 0;
+        long long bbbv = 0, openings = 0, islands = 0, zini = 0;
+        Board board;
+        for (int r = 0; r < reps; ++r) {
+            board.reset(rows, cols);
+            for (const auto& p : bitmapToPositions(generateMines((uint32_t)(rows * cols), (uint32_t)mines, (uint64_t)r + 1), cols)) {
+                board.setMine(board.index(p.first, p.second));
+            }
+            auto t0 = Clock::now();
+            board.computeAdjacency();
+            adjacencyUs += secondsSince(t0) * 1e6;
+            t0 = Clock::now();
+            BoardMetrics m = computeBoardMetrics(board);
+            metricsUs += secondsSince(t0) * 1e6;
+            bbbv += m.bbbv;
+            openings += m.openings;
+            islands += m.islands;
+            zini += m.zini;
+        }
+        cout << "  " << setw(4) << rows << "x" << setw(4) << left << cols << right << setw(7) << mines << " 雷" << fixed << setprecision(2)
+             << "  指标 " << setw(10) << metricsUs / reps << "  周围雷数 " << setw(9) << adjacencyUs / reps << setprecision(1)
+             << "  平均 3BV " << setw(8) << (double)bbbv / reps << "  开局区域 " << setw(7) << (double)openings / reps
+             << "  孤岛 " << setw(7) << (double)islands / reps << "  ZiNi " << setw(8) << (double)zini / reps << endl;
+    }
+}
+
+// ---------------------------------------------------------------------------
+struct BenchEntry {
+    const char* name;
+    void (*fn)();
+};
+
+static const BenchEntry BENCHES[] = {
+    {"layout", benchLayout},
+    {"flood", benchFlood},
+    {"diff", benchDiffBytes},
+    {"frames", benchFrames},
+    {"place", benchPlacement},
+    {"adjacency", benchAdjacency},
+    {"simd", benchSimd},
+    {"fileio", benchFileIO},
+    {"archive", benchArchive},
+    {"snapshot", benchSnapshot},
+    {"seed", benchSeed},
+    {"eventlog", benchEventLog},
+    {"replay", benchReplay},
+    {"chord", benchChord},
+    {"firstclick", benchFirstClick},
+    {"noguess", benchNoGuess},
+    {"batch", benchBatch},
+    {"probability", benchProbability},
+    {"bot", benchBot},
+    {"metrics", benchMetrics},
+};
+
+int main(int argc, char** argv) {
+    bool any = false;
+    for (const auto& b : BENCHES) {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i) {
+            if (strcmp(argv[i], b.name) == 0) selected = true;
+        }
+        if (selected) {
+            b.fn();
+            cout << endl;
+            any = true;
+        }
+    }
+    if (!any) {
+        cerr << "未知的基准名称。可用：";
+        for (const auto& b : BENCHES) cerr << " " << b.name;
+        cerr << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "adjacency.h"
+
+// 单元格状态
+enum CellStatus { HIDDEN, REVEALED, FLAGGED };
+
+// 局面统计，由 Board 在揭示/标记时增量维护
+struct BoardStats {
+    int mines;        // 雷总数
+    int flags;        // 已插旗数
+    int correctFlags; // 插在雷上的旗数
+    int hiddenSafe;   // 尚未揭示的非雷格子数，为 0 即获胜
+    int minesLeft;    // 界面显示的剩余雷数 = mines - flags
+};
+
+// 扁平棋盘：所有格子存放在一块连续内存中，每格一个字节。
+// 四周多留一圈边框格子，邻居循环不需要做越界检查。
+//
+// 字节布局：
+//   bit 0-3  周围雷数 (0-8)
+//   bit 4    是否为雷
+//   bit 5-6  状态 (HIDDEN / REVEALED / FLAGGED)
+//   bit 7    边框标记
+class Board {
+public:
+    static const uint8_t COUNT_MASK = 0x0F;
+    static const uint8_t MINE_BIT = 0x10;
+    static const int STATUS_SHIFT = 5;
+    static const uint8_t STATUS_MASK = 0x60;
+    static const uint8_t BORDER_BIT = 0x80;
+    static const uint8_t REVEALED_BITS = REVEALED << STATUS_SHIFT;
+    static const uint8_t FLAGGED_BITS = FLAGGED << STATUS_SHIFT;
+    // 边框格子视为已揭示且无雷，揭示和计数时会被自然跳过
+    static const uint8_t BORDER_CELL = BORDER_BIT | REVEALED_BITS;
+
+    Board() : rows_(0), cols_(0), stride_(2), mines_(0), flags_(0), correctFlags_(0), hiddenSafe_(0) {}
+
+    // 重新分配棋盘，所有格子清空为隐藏、无雷
+    void reset(int rows, int cols) {
+        rows_ = rows;
+        cols_ = cols;
+        stride_ = cols + 2;
+        cells_.assign((size_t)(rows + 2) * stride_, 0);
+        for (int j = 0; j < stride_; ++j) {
+            cells_[j] = BORDER_CELL;
+            cells_[(size_t)(rows + 1) * stride_ + j] = BORDER_CELL;
+        }
+        for (int i = 1; i <= rows; ++i) {
+            cells_[(size_t)i * stride_] = BORDER_CELL;
+            cells_[(size_t)i * stride_ + cols + 1] = BORDER_CELL;
+        }
+        offsets_[0] = -stride_ - 1; offsets_[1] = -stride_; offsets_[2] = -stride_ + 1;
+        offsets_[3] = -1;                                   offsets_[4] = 1;
+        offsets_[5] = stride_ - 1;  offsets_[6] = stride_;  offsets_[7] = stride_ + 1;
+        mines_ = 0;
+        flags_ = 0;
+        correctFlags_ = 0;
+        hiddenSafe_ = rows * cols;
+    }
+
+    int rows() const { return rows_; }
+    int cols() const { return cols_; }
+    int stride() const { return stride_; }
+    int cellCount() const { return rows_ * cols_; }
+
+    // (行, 列) 与带边框下标之间的换算
+    int index(int row, int col) const { return (row + 1) * stride_ + col + 1; }
+    int rowOf(int idx) const { return idx / stride_ - 1; }
+    int colOf(int idx) const { return idx % stride_ - 1; }
+    bool inside(int row, int col) const { return row >= 0 && row < rows_ && col >= 0 && col < cols_; }
+
+    // 8 个邻居相对当前下标的偏移量
+    const int* neighbours() const { return offsets_; }
+
+    bool isMine(int idx) const { return (cells_[idx] & MINE_BIT) != 0; }
+    bool isBorder(int idx) const { return (cells_[idx] & BORDER_BIT) != 0; }
+    int adjacent(int idx) const { return cells_[idx] & COUNT_MASK; }
+    CellStatus statusAt(int idx) const { return (CellStatus)((cells_[idx] & STATUS_MASK) >> STATUS_SHIFT); }
+
+    void setMine(int idx) {
+        if (!(cells_[idx] & MINE_BIT)) {
+            cells_[idx] |= MINE_BIT;
+            mines_++;
+            hiddenSafe_--;
+        }
+    }
+    // 布局延迟生成时先登记雷数，统计和界面上的剩余雷数照常显示；放雷后由 recount() 重新统计
+    void setPendingMines(int mines) {
+        mines_ = mines;
+        hiddenSafe_ = rows_ * cols_ - mines;
+    }
+    void setAdjacent(int idx, int count) { cells_[idx] = (uint8_t)((cells_[idx] & ~COUNT_MASK) | count); }
+    // 直接改写状态，不维护统计；批量改写后需调用 recount()
+    void setStatus(int idx, CellStatus s) { cells_[idx] = (uint8_t)((cells_[idx] & ~STATUS_MASK) | (s << STATUS_SHIFT)); }
+
+    // 切换标记，已揭示的格子不变。返回切换后的状态
+    CellStatus toggleFlag(int idx) {
+        uint8_t st = cells_[idx] & STATUS_MASK;
+        if (st == REVEALED_BITS) {
+            return REVEALED;
+        }
+        int delta = st == FLAGGED_BITS ? -1 : 1;
+        cells_[idx] ^= FLAGGED_BITS; // HIDDEN(00) <-> FLAGGED(10)
+        flags_ += delta;
+        if (cells_[idx] & MINE_BIT) {
+            correctFlags_ += delta;
+        }
+        return delta > 0 ? FLAGGED : HIDDEN;
+    }
+
+    // O(1) 统计查询
+    int mineCount() const { return mines_; }
+    int hiddenSafe() const { return hiddenSafe_; }
+    int correctFlags() const { return correctFlags_; }
+    BoardStats stats() const { return {mines_, flags_, correctFlags_, hiddenSafe_, mines_ - flags_}; }
+
+    // 全盘重新统计，用于 setStatus 批量改写之后。
+    // 状态只有 00/01/10 三种，bit 5 即已揭示、bit 6 即已标记，逐位相加不需要分支
+    void recount() {
+        mines_ = flags_ = correctFlags_ = hiddenSafe_ = 0;
+        for (int i = 0; i < rows_; ++i) {
+            const uint8_t* r = row(i);
+            int mines = 0, flags = 0, correct = 0, hidden = 0;
+            for (int j = 0; j < cols_; ++j) {
+                int mine = (r[j] >> 4) & 1;
+                int revealed = (r[j] >> STATUS_SHIFT) & 1;
+                int flag = (r[j] >> (STATUS_SHIFT + 1)) & 1;
+                mines += mine;
+                flags += flag;
+                correct += mine & flag;
+                hidden += (mine | revealed) ^ 1;
+            }
+            mines_ += mines;
+            flags_ += flags;
+            correctFlags_ += correct;
+            hiddenSafe_ += hidden;
+        }
+    }
+
+    // 根据雷的位置计算所有格子的周围雷数（雷格子为 0），见 adjacency.h
+    void computeAdjacency() {
+        if (rows_ > 0) {
+            computeAdjacencyFast(cells_.data(), rows_, cols_, stride_);
+        }
+    }
+
+    // 揭示 idx，返回 false 表示踩到雷
+    bool reveal(int idx, std::vector<int>& revealed) {
+        return revealBatch(&idx, 1, revealed);
+    }
+
+    // 一次揭示多个格子（双击），返回 false 表示其中有雷。
+    // 所有隐藏的起点先一起入队，再用同一个显式工作队列展开空白区域（多源 BFS），不递归，
+    // 巨大的空白区域也不会栈溢出；几个起点连着同一片空白区域时这片区域只扫描一遍。
+    // 新揭示的格子下标按揭示顺序追加到 revealed 末尾；revealed 同时充当 BFS 队列，
+    // 格子入队时即标记为已揭示，每格最多入队一次，整片区域一次线性扫描完成。
+    // 调用方复用同一个 revealed 即可避免重复分配。
+    bool revealBatch(const int* sources, int count, std::vector<int>& revealed) {
+        uint8_t* cells = cells_.data();
+        size_t start = revealed.size();
+        int minesHit = 0;
+        for (int s = 0; s < count; ++s) {
+            int idx = sources[s];
+            if ((cells[idx] & STATUS_MASK) == 0) { // 跳过边框、已揭示和已标记的格子
+                cells[idx] |= REVEALED_BITS;
+                revealed.push_back(idx);
+                minesHit += (cells[idx] & MINE_BIT) != 0;
+            }
+        }
+        size_t head = start;
+        while (head < revealed.size()) {
+            int cur = revealed[head++];
+            if (cells[cur] & (COUNT_MASK | MINE_BIT)) {
+                continue; // 数字格和雷不继续展开
+            }
+            for (int k = 0; k < 8; ++k) {
+                int n = cur + offsets_[k];
+                if ((cells[n] & STATUS_MASK) == 0) { // 空白格的邻居一定不是雷
+                    cells[n] |= REVEALED_BITS;
+                    revealed.push_back(n);
+                }
+            }
+        }
+        hiddenSafe_ -= (int)(revealed.size() - start) - minesHit;
+        return minesHit == 0;
+    }
+
+    // 状态位平面：第 w 个 64 位字对应格子编号（row * cols + col）w*64 起的 64 个格子，
+    // revealed / flagged 中的位表示该格已揭示 / 已标记。存档按字逐个读写，不需要整张平面的缓冲区
+    void statusWords(size_t w, uint64_t& revealed, uint64_t& flagged) const {
+        uint64_t i = (uint64_t)w * 64;
+        uint64_t end = (uint64_t)rows_ * cols_;
+        int r = (int)(i / cols_);
+        int c = (int)(i % cols_);
+        const uint8_t* p = row(r);
+        revealed = flagged = 0;
+        int b = 0;
+        while (b < 64 && i < end) {
+            // 按行分段处理，段内不需要判断换行
+            int run = (int)std::min<uint64_t>(std::min(64 - b, cols_ - c), end - i);
+            for (int k = 0; k < run; ++k) {
+                uint64_t v = p[c + k];
+                revealed |= ((v >> STATUS_SHIFT) & 1) << (b + k);       // REVEALED_BITS 为 bit 5
+                flagged |= ((v >> (STATUS_SHIFT + 1)) & 1) << (b + k); // FLAGGED_BITS 为 bit 6
+            }
+            b += run;
+            i += run;
+            c += run;
+            if (c == cols_) {
+                c = 0;
+                p = row(++r);
+            }
+        }
+    }
+
+    // statusWords 的逆操作，直接改写状态，全部写完后需调用 recount()
+    void setStatusWords(size_t w, uint64_t revealed, uint64_t flagged) {
+        uint64_t i = (uint64_t)w * 64;
+        uint64_t end = (uint64_t)rows_ * cols_;
+        int r = (int)(i / cols_);
+        int c = (int)(i % cols_);
+        uint8_t* p = cells_.data() + index(r, 0);
+        flagged &= ~revealed; // 两个平面都置位时按已揭示处理
+        int b = 0;
+        while (b < 64 && i < end) {
+            int run = (int)std::min<uint64_t>(std::min(64 - b, cols_ - c), end - i);
+            for (int k = 0; k < run; ++k) {
+                uint8_t st = (uint8_t)((((revealed >> (b + k)) & 1) << STATUS_SHIFT) | (((flagged >> (b + k)) & 1) << (STATUS_SHIFT + 1)));
+                p[c + k] = (uint8_t)((p[c + k] & ~STATUS_MASK) | st);
+            }
+            b += run;
+            i += run;
+            c += run;
+            if (c == cols_) {
+                c = 0;
+                p += stride_;
+            }
+        }
+    }
+
+    // 原始字节，供批量处理使用
+    uint8_t* data() { return cells_.data(); }
+    const uint8_t* data() const { return cells_.data(); }
+    // 第 row 行第 0 列的地址，整行 cols() 个字节连续
+    const uint8_t* row(int row) const { return cells_.data() + index(row, 0); }
+
+private:
+    int rows_;
+    int cols_;
+    int stride_;
+    int offsets_[8];
+    int mines_;
+    int flags_;
+    int correctFlags_;
+    int hiddenSafe_;
+    std::vector<uint8_t> cells_;
+};
@@ -0,0 +1,463 @@
+#pragma once
+
+// .sl 棋盘文件的读写。
+//
+// 第 1 版（旧版）是文本：第一行 "行数 列数 雷数"，之后每行一个雷的 "行 列"。
+// 第 2 版是二进制：固定 64 字节的文件头后面紧跟数据区，数据区有两种编码：
+//   位图    与 generator.h 的 MineBitmap 相同：第 row*cols+col 位，64 位小端字打包
+//   Rice    雷位置的间隔压缩编码（见 rice.h），稀疏布局比位图小得多
+//   种子    数据区为空，由文件头的尺寸、雷数和种子用 generateMines 重新生成
+// 读取时把整个文件映射到内存，校验文件头和校验和后直接从映射的内存解码到位图，不做任何文本解析。
+// 读取函数按文件开头的魔数自动识别两种格式。
+//
+// 对局快照是带状态区的第 2 版文件：数据区之后是 SlGameState（光标、用时、是否已走第一步），
+// 再接每格 2 位的状态位平面，按 64 格一组交替存放已揭示字和已标记字，可以边生成边写出。
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "board.h"
+#include "generator.h"
+#include "rice.h"
+
+const char SL_MAGIC[4] = {'S', 'L', 'B', 0x1A}; // 0x1A 防止被当作文本文件误读
+const uint16_t SL_VERSION = 2;
+
+// 数据区编码
+enum SlEncoding { SL_ENCODING_BITMAP = 0, SL_ENCODING_RICE = 1, SL_ENCODING_SEED = 2 };
+
+// 文件头 flags
+const uint32_t SL_FLAG_SNAPSHOT = 1; // 数据区之后有对局状态区
+
+// 可加载的最大边长：Board 的下标和格子数都是 int，(边长 + 2) 的平方必须放得下
+const uint64_t SL_MAX_SIDE = 1 << 15;
+
+// 行列数在 1..SL_MAX_SIDE 之间，且至少留一个安全格
+inline bool validBoardSize(uint64_t rows, uint64_t cols, uint64_t mines) {
+    return rows > 0 && cols > 0 && rows <= SL_MAX_SIDE && cols <= SL_MAX_SIDE && mines < rows * cols;
+}
+
+// 文件头，所有字段小端存储
+struct SlHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t encoding;
+    uint32_t rows;
+    uint32_t cols;
+    uint32_t mines;
+    uint32_t flags;
+    uint64_t seed;          // 生成这个布局的随机种子，未知时为 0
+    uint64_t payloadSize;   // 数据区字节数
+    uint64_t checksum;      // 数据区的 FNV-1a 64 位校验和
+    uint64_t stateSize;     // 状态区字节数，没有状态区时为 0
+    uint64_t stateChecksum; // 状态区的 FNV-1a 64 位校验和
+};
+static_assert(sizeof(SlHeader) == 64, "SlHeader 必须是 64 字节");
+
+// 状态区开头的对局信息
+struct SlGameState {
+    uint32_t cursorRow;
+    uint32_t cursorCol;
+    uint64_t elapsedMs;
+    uint8_t firstMove;
+    uint8_t reserved[15];
+};
+static_assert(sizeof(SlGameState) == 32, "SlGameState 必须是 32 字节");
+
+// 快照中除棋盘格子状态之外的对局信息
+struct SnapshotInfo {
+    int cursorRow = 0;
+    int cursorCol = 0;
+    uint64_t elapsedMs = 0;
+    bool firstMove = true;
+};
+
+class MappedFile;
+
+// 一个棋盘布局：尺寸、雷数、种子和雷位图
+struct BoardLayout {
+    int rows = 0;
+    int cols = 0;
+    int mines = 0;
+    uint64_t seed = 0;
+    MineBitmap bits;
+
+    // 从快照文件读出时才有：对局信息和状态位平面。状态位平面不拷贝，statusPlanes 直接指向映射的文件
+    // （已揭示字、已标记字交替存放），source 持有映射使其保持有效，交给 Game::restoreStatus 逐字恢复
+    bool hasSnapshot = false;
+    SnapshotInfo snapshot;
+    const uint8_t* statusPlanes = nullptr;
+    size_t statusWords = 0;
+    std::shared_ptr<const MappedFile> source;
+
+    std::vector<std::pair<int, int>> positions() const { return bitmapToPositions(bits, cols); }
+};
+
+// 由雷位置列表构造布局，重复的位置只算一次
+inline BoardLayout layoutFromPositions(int rows, int cols, const std::vector<std::pair<int, int>>& positions, uint64_t seed = 0) {
+    BoardLayout layout;
+    layout.rows = rows;
+    layout.cols = cols;
+    layout.seed = seed;
+    layout.bits.assign(((uint64_t)rows * cols + 63) / 64, 0);
+    for (const auto& p : positions) {
+        uint64_t i = (uint64_t)p.first * cols + p.second;
+        if (!testBit(layout.bits, i)) {
+            setBit(layout.bits, i);
+            layout.mines++;
+        }
+    }
+    return layout;
+}
+
+// 64 位 FNV-1a，按字节处理
+inline uint64_t fnv1a64(const uint8_t* data, size_t size, uint64_t hash = 0xcbf29ce484222325ULL) {
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+// 只读内存映射文件，析构时解除映射
+class MappedFile {
+public:
+    MappedFile() : data_(nullptr), size_(0) {
+#ifdef _WIN32
+        file_ = INVALID_HANDLE_VALUE;
+        mapping_ = nullptr;
+#endif
+    }
+    ~MappedFile() { close(); }
+
+    bool open(const std::string& path) {
+        close();
+#ifdef _WIN32
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file_, &size)) return false;
+        size_ = (size_t)size.QuadPart;
+        if (size_ == 0) return true; // 空文件不能映射
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping_) return false;
+        data_ = (const uint8_t*)MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+        return data_ != nullptr;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        size_ = (size_t)st.st_size;
+        if (size_ == 0) {
+            ::close(fd);
+            return true;
+        }
+        void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // 映射建立后文件描述符可以关闭
+        if (p == MAP_FAILED) {
+            size_ = 0;
+            return false;
+        }
+        data_ = (const uint8_t*)p;
+        return true;
+#endif
+    }
+
+    void close() {
+#ifdef _WIN32
+        if (data_) UnmapViewOfFile(data_);
+        if (mapping_) CloseHandle(mapping_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+        file_ = INVALID_HANDLE_VALUE;
+        mapping_ = nullptr;
+#else
+        if (data_) munmap((void*)data_, size_);
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    const uint8_t* data_;
+    size_t size_;
+#ifdef _WIN32
+    HANDLE file_;
+    HANDLE mapping_;
+#endif
+};
+
+// 数据区最小的编码：布局能由种子重新生成时只记录种子，否则取位图和 Rice 中较小的一种
+inline SlEncoding smallestEncoding(const BoardLayout& layout) {
+    uint32_t cells = (uint32_t)layout.rows * (uint32_t)layout.cols;
+    if (layout.seed != 0 && generateMines(cells, (uint32_t)layout.mines, layout.seed) == layout.bits) {
+        return SL_ENCODING_SEED;
+    }
+    return riceEncodedSize(layout.bits, cells, (uint32_t)layout.mines) < layout.bits.size() * sizeof(uint64_t) ? SL_ENCODING_RICE : SL_ENCODING_BITMAP;
+}
+
+// 写入第 2 版二进制文件；board 不为空时追加状态区，成为对局快照
+inline bool writeBoardBinary(const std::string& path, const BoardLayout& layout, SlEncoding encoding,
+                             const Board* board, const SnapshotInfo* info, std::string& error) {
+    const uint8_t* payload = (const uint8_t*)layout.bits.data();
+    size_t payloadSize = layout.bits.size() * sizeof(uint64_t);
+    std::vector<uint8_t> encoded;
+    if (encoding == SL_ENCODING_RICE) {
+        riceEncode(layout.bits, (uint32_t)layout.rows * (uint32_t)layout.cols, (uint32_t)layout.mines, encoded);
+        payload = encoded.data();
+        payloadSize = encoded.size();
+    } else if (encoding == SL_ENCODING_SEED) {
+        payloadSize = 0;
+    }
+
+    SlHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SL_MAGIC, 4);
+    header.version = SL_VERSION;
+    header.encoding = (uint16_t)encoding;
+    header.rows = (uint32_t)layout.rows;
+    header.cols = (uint32_t)layout.cols;
+    header.mines = (uint32_t)layout.mines;
+    header.seed = layout.seed;
+    header.payloadSize = payloadSize;
+    header.checksum = fnv1a64(payload, payloadSize);
+
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) {
+        error = "无法创建文件 " + path;
+        return false;
+    }
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+              fwrite(payload, 1, payloadSize, f) == payloadSize;
+
+    if (ok && board) {
+        SlGameState state;
+        memset(&state, 0, sizeof(state));
+        state.cursorRow = (uint32_t)info->cursorRow;
+        state.cursorCol = (uint32_t)info->cursorCol;
+        state.elapsedMs = info->elapsedMs;
+        state.firstMove = info->firstMove ? 1 : 0;
+        ok = fwrite(&state, sizeof(state), 1, f) == 1;
+        uint64_t hash = fnv1a64((const uint8_t*)&state, sizeof(state));
+
+        // 状态平面按块生成、计算校验和并写出
+        size_t words = (size_t)(((uint64_t)layout.rows * layout.cols + 63) / 64);
+        uint64_t chunk[1024];
+        for (size_t w = 0; ok && w < words;) {
+            size_t n = 0;
+            for (; n < 1024 && w < words; n += 2, ++w) {
+                board->statusWords(w, chunk[n], chunk[n + 1]);
+            }
+            hash = fnv1a64((const uint8_t*)chunk, n * sizeof(uint64_t), hash);
+            ok = fwrite(chunk, sizeof(uint64_t), n, f) == n;
+        }
+
+        // 状态区写完才知道校验和，回头补写文件头
+        header.flags |= SL_FLAG_SNAPSHOT;
+        header.stateSize = sizeof(SlGameState) + (uint64_t)words * 2 * sizeof(uint64_t);
+        header.stateChecksum = hash;
+        ok = ok && fseek(f, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, f) == 1;
+    }
+
+    ok = fclose(f) == 0 && ok;
+    if (!ok) error = "写入文件失败 " + path;
+    return ok;
+}
+
+inline bool saveBoardBinary(const std::string& path, const BoardLayout& layout, std::string& error, SlEncoding encoding = SL_ENCODING_BITMAP) {
+    return writeBoardBinary(path, layout, encoding, nullptr, nullptr, error);
+}
+
+// 保存进行中的对局：layout 为雷的布局，格子状态直接从 board 读取
+inline bool saveGameSnapshot(const std::string& path, const BoardLayout& layout, const Board& board, const SnapshotInfo& info,
+                             std::string& error, SlEncoding encoding = SL_ENCODING_BITMAP) {
+    return writeBoardBinary(path, layout, encoding, &board, &info, error);
+}
+
+// 写入第 1 版文本文件，供旧版本程序读取
+inline bool saveBoardText(const std::string& path, const BoardLayout& layout, std::string& error) {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        error = "无法创建文件 " + path;
+        return false;
+    }
+    out << layout.rows << " " << layout.cols << " " << layout.mines << "\n";
+    for (const auto& pos : layout.positions()) {
+        out << pos.first << " " << pos.second << "\n";
+    }
+    if (!out) {
+        error = "写入文件失败 " + path;
+        return false;
+    }
+    return true;
+}
+
+// 解析第 1 版文本文件，边读边写入位图
+inline bool loadBoardText(const std::string& path, BoardLayout& layout, std::string& error) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        error = "无法打开文件 " + path;
+        return false;
+    }
+    int rows, cols, mines;
+    if (!(in >> rows >> cols >> mines) || rows <= 0 || cols <= 0 || mines < 0 || !validBoardSize(rows, cols, mines)) {
+        error = "文件格式错误！";
+        return false;
+    }
+    layout = BoardLayout();
+    layout.rows = rows;
+    layout.cols = cols;
+    layout.bits.assign(((uint64_t)rows * cols + 63) / 64, 0);
+    for (int i = 0; i < mines; ++i) {
+        int row, col;
+        if (!(in >> row >> col) || row < 0 || row >= rows || col < 0 || col >= cols) {
+            error = "文件格式错误或雷的位置超出范围！";
+            return false;
+        }
+        uint64_t idx = (uint64_t)row * cols + col;
+        if (!testBit(layout.bits, idx)) { // 重复的位置只算一次
+            setBit(layout.bits, idx);
+            layout.mines++;
+        }
+    }
+    return true;
+}
+
+// 校验第 2 版文件头和数据区，通过后把位图拷入 layout。快照的状态位平面只记录指向 data 的指针，
+// 使用时 data 必须仍然有效
+inline bool decodeBoardBinary(const uint8_t* data, size_t size, BoardLayout& layout, std::string& error) {
+    SlHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.version != SL_VERSION) {
+        error = "不支持的文件版本 " + std::to_string(header.version);
+        return false;
+    }
+    uint64_t cells = (uint64_t)header.rows * header.cols;
+    if (!validBoardSize(header.rows, header.cols, header.mines)) {
+        error = "文件头中的棋盘尺寸不合法！";
+        return false;
+    }
+    if (header.payloadSize > size - sizeof(SlHeader) || header.stateSize > size - sizeof(SlHeader) - header.payloadSize) {
+        error = "文件不完整！";
+        return false;
+    }
+    const uint8_t* payload = data + sizeof(SlHeader);
+    if (fnv1a64(payload, (size_t)header.payloadSize) != header.checksum) {
+        error = "文件校验和不匹配，文件已损坏！";
+        return false;
+    }
+
+    layout.rows = (int)header.rows;
+    layout.cols = (int)header.cols;
+    layout.mines = (int)header.mines;
+    layout.seed = header.seed;
+    size_t words = (size_t)((cells + 63) / 64);
+    if (header.encoding == SL_ENCODING_BITMAP) {
+        if (header.payloadSize != words * sizeof(uint64_t)) {
+            error = "雷位图大小与棋盘尺寸不符！";
+            return false;
+        }
+        layout.bits.resize(words);
+        memcpy(layout.bits.data(), payload, (size_t)header.payloadSize);
+    } else if (header.encoding == SL_ENCODING_SEED) {
+        if (header.payloadSize != 0 || header.seed == 0) {
+            error = "种子编码的文件头不合法！";
+            return false;
+        }
+        layout.bits = generateMines((uint32_t)cells, header.mines, header.seed);
+    } else if (header.encoding == SL_ENCODING_RICE) {
+        if (!riceDecode(payload, (size_t)header.payloadSize, (uint32_t)cells, header.mines, layout.bits)) {
+            error = "压缩数据损坏！";
+            return false;
+        }
+    } else {
+        error = "不支持的数据编码 " + std::to_string(header.encoding);
+        return false;
+    }
+
+    // 末尾多余的位必须为 0，位图中的雷数必须与文件头一致
+    if (cells % 64 && (layout.bits.back() >> (cells % 64)) != 0) {
+        error = "雷位图超出棋盘范围！";
+        return false;
+    }
+    uint64_t count = 0;
+    for (uint64_t w : layout.bits) count += popcount64(w);
+    if (count != header.mines) {
+        error = "雷位图中的雷数与文件头不符！";
+        return false;
+    }
+
+    layout.hasSnapshot = false;
+    layout.statusPlanes = nullptr;
+    layout.statusWords = 0;
+    layout.source.reset();
+    if (!(header.flags & SL_FLAG_SNAPSHOT)) {
+        return true;
+    }
+    const uint8_t* state = payload + header.payloadSize;
+    if (header.stateSize != sizeof(SlGameState) + (uint64_t)words * 2 * sizeof(uint64_t)) {
+        error = "状态区大小与棋盘尺寸不符！";
+        return false;
+    }
+    if (fnv1a64(state, (size_t)header.stateSize) != header.stateChecksum) {
+        error = "状态区校验和不匹配，文件已损坏！";
+        return false;
+    }
+    SlGameState gs;
+    memcpy(&gs, state, sizeof(gs));
+    if (gs.cursorRow >= header.rows || gs.cursorCol >= header.cols) {
+        error = "快照中的光标位置超出棋盘！";
+        return false;
+    }
+    layout.hasSnapshot = true;
+    layout.snapshot.cursorRow = (int)gs.cursorRow;
+    layout.snapshot.cursorCol = (int)gs.cursorCol;
+    layout.snapshot.elapsedMs = gs.elapsedMs;
+    layout.snapshot.firstMove = gs.firstMove != 0;
+    layout.statusPlanes = state + sizeof(SlGameState);
+    layout.statusWords = words;
+    return true;
+}
+
+// 读取 .sl 文件，自动识别二进制和文本两种格式
+inline bool loadBoardFile(const std::string& path, BoardLayout& layout, std::string& error) {
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>();
+    if (!file->open(path)) {
+        error = "无法打开文件 " + path;
+        return false;
+    }
+    if (file->size() >= sizeof(SlHeader) && memcmp(file->data(), SL_MAGIC, 4) == 0) {
+        if (!decodeBoardBinary(file->data(), file->size(), layout, error)) return false;
+        if (layout.hasSnapshot) layout.source = file; // 快照的状态位平面还要从映射中读取
+        return true;
+    }
+    file->close();
+    return loadBoardText(path, layout, error);
+}
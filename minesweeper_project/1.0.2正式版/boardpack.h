@@ -0,0 +1,248 @@
+#pragma once
+
+// 布局包（.slp）：一次离线生成大量同样尺寸的布局，顺序存放在一个文件里。
+//
+// 固定 64 字节的文件头之后是逐条记录，每个布局一条：
+//   varint 第一次揭示的行号 + 1（0 表示普通布局，没有指定第一次揭示）
+//   varint 第一次揭示的列号
+//   varint Rice 数据字节数，之后是 Rice 编码的雷位置（见 rice.h）
+// 第 i 个布局的种子是 CounterRng(主种子).at(i)，只由主种子和序号决定，与生成时用了多少线程、
+// 哪个线程生成了它都无关，同一主种子生成的文件逐字节相同。
+// 普通布局就是 generateMines(种子)；无猜布局从棋盘中心开始（generateNoGuess），中心记在记录里。
+//
+// 生成时按窗口分批：线程池（pool.h）生成一个窗口的记录，同时另一个线程按顺序写出上一个窗口，
+// 内存中最多只有两个窗口，文件写完后再回头补写文件头中的数量和校验和。
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "boardfile.h"
+#include "generator.h"
+#include "pool.h"
+#include "rice.h"
+#include "solver.h"
+
+const char PACK_MAGIC[4] = {'S', 'L', 'P', 'K'};
+const uint16_t PACK_VERSION = 1;
+
+// 文件头 flags
+const uint16_t PACK_FLAG_NO_GUESS = 1; // 无猜布局
+
+// 文件头，所有字段小端存储
+struct PackHeader {
+    char magic[4];
+    uint16_t version;
+    uint16_t flags;
+    uint32_t rows;
+    uint32_t cols;
+    uint32_t mines;
+    uint32_t reserved;
+    uint64_t masterSeed;
+    uint64_t count;       // 布局数
+    uint64_t payloadSize; // 记录区字节数
+    uint64_t checksum;    // 记录区的 FNV-1a 64 位校验和
+    uint64_t reserved2;
+};
+static_assert(sizeof(PackHeader) == 64, "PackHeader 必须是 64 字节");
+
+// 生成参数
+struct PackOptions {
+    int rows = 16;
+    int cols = 30;
+    int mines = 99;
+    uint64_t masterSeed = 1;
+    uint64_t count = 0;
+    bool noGuess = false;
+    int threads = 0;         // 0 表示全部硬件线程
+    size_t windowSize = 4096; // 每个窗口的布局数
+};
+
+// 生成结果的统计
+struct PackStats {
+    uint64_t boards = 0;
+    uint64_t failed = 0;   // 无猜模式下尝试次数用完仍需要猜的布局（照常写入，第一次揭示仍然安全）
+    uint64_t attempts = 0; // 无猜模式下的总尝试次数
+    uint64_t bytes = 0;    // 文件大小
+};
+
+// 第 index 个布局的种子
+inline uint64_t packBoardSeed(uint64_t masterSeed, uint64_t index) {
+    return CounterRng(masterSeed).at(index);
+}
+
+// 生成第 index 个布局并编码为一条记录，attempts 返回无猜模式的尝试次数
+inline bool encodePackRecord(const PackOptions& o, uint64_t index, std::vector<uint8_t>& record, int& attempts) {
+    uint64_t seed = packBoardSeed(o.masterSeed, index);
+    uint32_t cells = (uint32_t)o.rows * (uint32_t)o.cols;
+    MineBitmap bits;
+    bool ok = true;
+    int firstRow = -1, firstCol = -1;
+    attempts = 0;
+    if (o.noGuess) {
+        firstRow = o.rows / 2;
+        firstCol = o.cols / 2;
+        ok = generateNoGuess(o.rows, o.cols, (uint32_t)o.mines, seed, firstRow, firstCol, bits, NO_GUESS_MAX_ATTEMPTS, &attempts);
+    } else {
+        bits = generateMines(cells, (uint32_t)o.mines, seed);
+    }
+    std::vector<uint8_t> rice;
+    riceEncode(bits, cells, (uint32_t)o.mines, rice);
+    record.clear();
+    auto putVarint = [&](uint64_t v) {
+        while (v >= 0x80) {
+            record.push_back((uint8_t)(v | 0x80));
+            v >>= 7;
+        }
+        record.push_back((uint8_t)v);
+    };
+    putVarint((uint64_t)(firstRow + 1));
+    putVarint((uint64_t)(firstCol + 1));
+    putVarint(rice.size());
+    record.insert(record.end(), rice.begin(), rice.end());
+    return ok;
+}
+
+// 生成布局包写入 path
+inline bool writeBoardPack(const std::string& path, const PackOptions& o, PackStats& stats, std::string& error) {
+    if (o.rows <= 0 || o.cols <= 0 || o.mines <= 0 || !validBoardSize((uint64_t)o.rows, (uint64_t)o.cols, (uint64_t)o.mines)) {
+        error = "棋盘大小或雷数无效";
+        return false;
+    }
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) {
+        error = "无法创建文件 " + path;
+        return false;
+    }
+    PackHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PACK_MAGIC, 4);
+    header.version = PACK_VERSION;
+    header.flags = o.noGuess ? PACK_FLAG_NO_GUESS : 0;
+    header.rows = (uint32_t)o.rows;
+    header.cols = (uint32_t)o.cols;
+    header.mines = (uint32_t)o.mines;
+    header.masterSeed = o.masterSeed;
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1; // 先占位，写完后补写
+
+    WorkStealingPool pool(o.threads);
+    size_t window = o.windowSize ? o.windowSize : 1;
+    std::vector<std::vector<uint8_t>> buffers[2] = {std::vector<std::vector<uint8_t>>(window), std::vector<std::vector<uint8_t>>(window)};
+    std::vector<uint64_t> threadFailed(pool.threads()), threadAttempts(pool.threads());
+    uint64_t hash = 0xcbf29ce484222325ULL, payloadSize = 0;
+    auto writeWindow = [&](const std::vector<std::vector<uint8_t>>& records, size_t n) {
+        bool written = true;
+        for (size_t j = 0; j < n && written; ++j) {
+            hash = fnv1a64(records[j].data(), records[j].size(), hash);
+            payloadSize += records[j].size();
+            written = fwrite(records[j].data(), 1, records[j].size(), f) == records[j].size();
+        }
+        return written;
+    };
+    std::future<bool> writing;
+    for (uint64_t first = 0; ok && first < o.count; first += window) {
+        size_t n = (size_t)std::min<uint64_t>(window, o.count - first);
+        std::vector<std::vector<uint8_t>>& records = buffers[(first / window) % 2];
+        pool.run(n, [&](size_t j, int t) {
+            int attempts;
+            threadFailed[t] += !encodePackRecord(o, first + j, records[j], attempts);
+            threadAttempts[t] += (uint64_t)attempts;
+        });
+        if (writing.valid()) ok = writing.get();
+        // 上一个窗口写完之后才能复用它的缓冲区；这个窗口在生成下一个窗口的同时写出
+        writing = std::async(std::launch::async, [&records, n, &writeWindow] { return writeWindow(records, n); });
+    }
+    if (writing.valid()) ok = writing.get() && ok;
+
+    for (int t = 0; t < pool.threads(); ++t) {
+        stats.failed += threadFailed[t];
+        stats.attempts += threadAttempts[t];
+    }
+    stats.boards = o.count;
+    stats.bytes = sizeof(header) + payloadSize;
+    header.count = o.count;
+    header.payloadSize = payloadSize;
+    header.checksum = hash;
+    ok = ok && fseek(f, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, f) == 1;
+    ok = fclose(f) == 0 && ok;
+    if (!ok) error = "写入文件失败 " + path;
+    return ok;
+}
+
+// 顺序读取布局包，直接解码映射的文件
+class PackReader {
+public:
+    PackReader() : p_(nullptr), end_(nullptr), index_(0) { memset(&header_, 0, sizeof(header_)); }
+
+    // 打开并校验文件头和校验和
+    bool open(const std::string& path, std::string& error) {
+        if (!file_.open(path)) {
+            error = "无法打开文件 " + path;
+            return false;
+        }
+        if (file_.size() < sizeof(PackHeader) || memcmp(file_.data(), PACK_MAGIC, 4) != 0) {
+            error = path + " 不是布局包文件";
+            return false;
+        }
+        memcpy(&header_, file_.data(), sizeof(header_));
+        if (header_.version != PACK_VERSION) {
+            error = "不支持的布局包版本";
+            return false;
+        }
+        if (!validBoardSize(header_.rows, header_.cols, header_.mines)) {
+            error = "布局包文件头中的棋盘尺寸不合法";
+            return false;
+        }
+        if (header_.payloadSize != file_.size() - sizeof(PackHeader) ||
+            fnv1a64(file_.data() + sizeof(PackHeader), (size_t)header_.payloadSize) != header_.checksum) {
+            error = "布局包校验和不符，文件已损坏";
+            return false;
+        }
+        p_ = file_.data() + sizeof(PackHeader);
+        end_ = p_ + header_.payloadSize;
+        index_ = 0;
+        return true;
+    }
+
+    const PackHeader& header() const { return header_; }
+
+    // 读出下一个布局，firstRow / firstCol 为第一次揭示的位置（普通布局为 -1）。读完或数据损坏时返回 false
+    bool next(BoardLayout& layout, int& firstRow, int& firstCol) {
+        uint64_t row, col, size;
+        if (index_ >= header_.count || !getVarint(row) || !getVarint(col) || !getVarint(size) || size > (uint64_t)(end_ - p_)) {
+            return false;
+        }
+        layout = BoardLayout();
+        layout.rows = (int)header_.rows;
+        layout.cols = (int)header_.cols;
+        layout.mines = (int)header_.mines;
+        firstRow = (int)row - 1;
+        firstCol = (int)col - 1;
+        // 普通布局可以由种子重新生成；无猜布局还取决于尝试次数，不记录种子
+        layout.seed = (header_.flags & PACK_FLAG_NO_GUESS) ? 0 : packBoardSeed(header_.masterSeed, index_);
+        bool ok = riceDecode(p_, (size_t)size, header_.rows * header_.cols, header_.mines, layout.bits);
+        p_ += size;
+        index_++;
+        return ok;
+    }
+
+private:
+    bool getVarint(uint64_t& v) {
+        v = 0;
+        for (int shift = 0; shift < 64 && p_ < end_; shift += 7) {
+            uint8_t byte = *p_++;
+            v |= (uint64_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+
+    MappedFile file_;
+    PackHeader header_;
+    const uint8_t* p_;
+    const uint8_t* end_;
+    uint64_t index_;
+};
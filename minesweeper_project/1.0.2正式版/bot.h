@@ -0,0 +1,187 @@
+#pragma once
+
+// 自动玩家：和真人一样只看得到已揭示的数字、旗子和总雷数，通过 Game::reveal / toggleFlag 一步一步下棋。
+// 每一步按代价从低到高决定：
+//   1. 已推出但还没执行的安全格或雷
+//   2. 单格规则（同 Solver 规则 1）：用工作队列，只重新检查最近变化过的数字格
+//   3. 概率分析（analyzer.h）：概率为 0 的格子都安全、为 1 的都是雷，一次全部记下
+//   4. 都没有时猜概率最小的格子；第一步揭示中心
+// 推出的雷都会插旗（概率分析把旗当作雷），所以旗总是对的。同样的布局总是下出同样的棋。
+
+#include <cstdint>
+#include <vector>
+
+#include "analyzer.h"
+#include "game.h"
+
+class Bot {
+public:
+    // 走一步：揭示或插旗一个格子。对局已结束时什么也不做，返回 false
+    bool step(Game& game) {
+        if (game.finished()) return false;
+        const Board& board = game.board();
+        if (board.stride() != stride_ || board.rows() != rows_) start(board);
+        cells_ = board.data();
+        nb_ = board.neighbours();
+        if (!started_) {
+            started_ = true;
+            if (!game.pending()) guesses_++; // 布局已经确定时第一步也可能踩雷
+            act(game, board.index(board.rows() / 2, board.cols() / 2), false);
+            return true;
+        }
+        int unknown[8];
+        while (true) {
+            // 1. 已推出的动作，执行前局面可能已经变了（例如被连锁揭示）
+            while (!actions_.empty()) {
+                Action a = actions_.back();
+                actions_.pop_back();
+                if (isUnknown(a.idx)) {
+                    act(game, a.idx, a.mine);
+                    return true;
+                }
+            }
+            // 2. 单格规则
+            if (!queue_.empty()) {
+                int idx = queue_.back();
+                queue_.pop_back();
+                queued_[idx] = 0;
+                int count;
+                int need = constraint(idx, unknown, count);
+                if (count > 0 && (need == 0 || need == count)) {
+                    for (int k = 0; k < count; ++k) actions_.push_back({unknown[k], need != 0});
+                }
+                continue;
+            }
+            // 3. 概率分析；4. 猜
+            int best = -1;
+            if (analyzer_.analyze(board, probability_)) {
+                double lowest = 2;
+                for (int i = 0; i < board.rows(); ++i) {
+                    for (int j = 0; j < board.cols(); ++j) {
+                        int idx = board.index(i, j);
+                        double p = probability_[idx];
+                        if (p < 0) continue;
+                        if (p < CERTAIN) {
+                            actions_.push_back({idx, false});
+                        } else if (p > 1 - CERTAIN) {
+                            actions_.push_back({idx, true});
+                        }
+                        if (p < lowest) {
+                            lowest = p;
+                            best = idx;
+                        }
+                    }
+                }
+            }
+            if (!actions_.empty()) continue;
+            if (best < 0) best = firstUnknown(board); // 分析失败只可能是局面矛盾，不会发生
+            if (best < 0) return false;
+            guesses_++;
+            act(game, best, false);
+            return true;
+        }
+    }
+
+    // 下到对局结束，返回结果
+    GameState play(Game& game) {
+        while (step(game)) {
+        }
+        return game.state();
+    }
+
+    // 换一局时调用（棋盘尺寸变化时 step 会自动重新开始）
+    void reset() { rows_ = stride_ = 0; }
+
+    int moves() const { return moves_; }     // 本局揭示和插旗的次数
+    int guesses() const { return guesses_; } // 其中没有把握的揭示次数
+
+private:
+    struct Action {
+        int idx;
+        bool mine;
+    };
+
+    // 低于这个值的概率当作 0（分析结果是精确计数的比值，只有舍入误差）
+    static constexpr double CERTAIN = 1e-9;
+
+    void start(const Board& board) {
+        rows_ = board.rows();
+        stride_ = board.stride();
+        queued_.assign((size_t)(rows_ + 2) * stride_, 0);
+        queue_.clear();
+        actions_.clear();
+        started_ = false;
+        moves_ = guesses_ = 0;
+    }
+
+    bool isUnknown(int idx) const { return (cells_[idx] & Board::STATUS_MASK) == 0; }
+    bool isNumber(int idx) const {
+        uint8_t c = cells_[idx];
+        return (c & (Board::BORDER_BIT | Board::STATUS_MASK)) == Board::REVEALED_BITS && (c & Board::COUNT_MASK) != 0;
+    }
+
+    // 周围的未知格写入 unknown，返回还需要的雷数
+    int constraint(int idx, int* unknown, int& count) const {
+        int flags = 0;
+        count = 0;
+        for (int k = 0; k < 8; ++k) {
+            int n = idx + nb_[k];
+            uint8_t st = cells_[n] & Board::STATUS_MASK;
+            if (st == 0) unknown[count++] = n;
+            flags += st == Board::FLAGGED_BITS;
+        }
+        return (cells_[idx] & Board::COUNT_MASK) - flags;
+    }
+
+    void enqueue(int idx) {
+        if (!queued_[idx]) {
+            queued_[idx] = 1;
+            queue_.push_back(idx);
+        }
+    }
+
+    // idx 变化后，周围数字格的约束需要重新检查
+    void touch(int idx) {
+        for (int k = 0; k < 8; ++k) {
+            int n = idx + nb_[k];
+            if (isNumber(n)) enqueue(n);
+        }
+    }
+
+    void act(Game& game, int idx, bool mine) {
+        int row = idx / stride_ - 1, col = idx % stride_ - 1;
+        moves_++;
+        if (mine) {
+            game.toggleFlag(row, col);
+            touch(idx);
+            return;
+        }
+        game.reveal(row, col);
+        for (int r : game.lastRevealed()) {
+            if (isNumber(r)) enqueue(r);
+            touch(r);
+        }
+    }
+
+    int firstUnknown(const Board& board) const {
+        for (int i = 0; i < board.rows(); ++i) {
+            for (int j = 0; j < board.cols(); ++j) {
+                if (isUnknown(board.index(i, j))) return board.index(i, j);
+            }
+        }
+        return -1;
+    }
+
+    ProbabilityAnalyzer analyzer_;
+    std::vector<double> probability_;
+    const uint8_t* cells_ = nullptr;
+    const int* nb_ = nullptr;
+    int rows_ = 0;
+    int stride_ = 0;
+    bool started_ = false;
+    int moves_ = 0;
+    int guesses_ = 0;
+    std::vector<uint8_t> queued_;
+    std::vector<int> queue_;       // 约束待检查的数字格
+    std::vector<Action> actions_;  // 已推出、待执行的动作
+};
@@ -0,0 +1,296 @@
+// 自动玩家工具（见 bot.h）
+//
+//   bottool play [局数] [--seed 十六进制主种子] [--custom 行数 列数 雷数]
+//        按难度选择中的三档（和自定义难度）各下若干局，统计胜率、每秒局数和每步耗时的分位数。
+//        第 i 局的种子是 CounterRng(主种子).at(i)，同一主种子每次下的棋完全相同，
+//        改动引擎（Board / Game / 生成器）之后用它做负载测试，结果可以直接比较。
+//
+//   bottool sweep 行数 列数 雷数 [--games 局数] [--threads 线程数] [--seed 十六进制主种子] [--out 文件.csv]
+//   bottool sweep --presets [同上的选项]
+//        蒙特卡洛估计胜率：行数、列数、雷数可以写成 10、8-20 或 8-20/4（步长），对每组参数用全部 CPU 各下若干局，
+//        输出 CSV：胜率和平均点击数（揭示和插旗）及其 95% 置信区间。--presets 只算难度选择中的三档，
+//        并检查胜率是否随难度降低。结果只取决于主种子，与线程数无关。
+//
+// 编译：g++ -O2 -std=c++17 -pthread bottool.cpp -o bottool
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bot.h"
+#include "pool.h"
+
+using namespace std;
+using Clock = chrono::steady_clock;
+
+// 难度选择中的三档（见 main.cpp chooseDifficulty）
+const int PRESETS[][3] = {{10, 10, 15}, {15, 15, 25}, {20, 20, 35}};
+const char* const PRESET_NAMES[] = {"初级", "中级", "高级"};
+
+// 每步耗时的直方图：16 纳秒以内每纳秒一格，更长的每个倍频程分 16 格（误差约 6%），内存固定
+struct LatencyHistogram {
+    vector<uint64_t> counts = vector<uint64_t>(64 * 16, 0);
+    uint64_t total = 0;
+    uint64_t maxNs = 0;
+
+    static int bucket(uint64_t ns) {
+        if (ns < 16) return (int)ns;
+        int e = 4;
+        while (ns >> (e + 1)) e++;
+        return (e - 3) * 16 + (int)((ns >> (e - 4)) & 15);
+    }
+    static uint64_t lower(int b) {
+        if (b < 16) return (uint64_t)b;
+        return (uint64_t)(16 + b % 16) << (b / 16 - 1);
+    }
+
+    void add(uint64_t ns) {
+        counts[bucket(ns)]++;
+        total++;
+        maxNs = max(maxNs, ns);
+    }
+    // 第 q 分位（0 < q < 1）所在格的下界
+    uint64_t percentile(double q) const {
+        uint64_t rank = (uint64_t)(q * (double)total), seen = 0;
+        for (size_t b = 0; b < counts.size(); ++b) {
+            seen += counts[b];
+            if (seen > rank) return lower((int)b);
+        }
+        return maxNs;
+    }
+};
+
+static int usage() {
+    cerr << "用法：bottool play [局数] [--seed 十六进制主种子] [--custom 行数 列数 雷数]" << endl;
+    cerr << "      bottool sweep 行数 列数 雷数 [--games 局数] [--threads 线程数] [--seed 十六进制主种子] [--out 文件.csv]" << endl;
+    cerr << "      bottool sweep --presets [--games 局数] [--threads 线程数] [--seed 十六进制主种子] [--out 文件.csv]" << endl;
+    return 2;
+}
+
+static string micros(uint64_t ns) {
+    ostringstream out;
+    out << fixed << setprecision(ns < 10000 ? 2 : 0) << ns / 1000.0;
+    return out.str();
+}
+
+// 下 games 局 rows x cols、mines 雷的对局
+static void play(int rows, int cols, int mines, uint64_t games, uint64_t masterSeed) {
+    Game game;
+    Bot bot;
+    LatencyHistogram latency;
+    CounterRng seeds(masterSeed);
+    uint64_t wins = 0, moves = 0, guesses = 0;
+    auto t0 = Clock::now();
+    for (uint64_t i = 0; i < games; ++i) {
+        game.createDeferred(rows, cols, mines, seeds.at(i));
+        bot.reset();
+        while (true) {
+            auto start = Clock::now();
+            bool moved = bot.step(game);
+            if (!moved) break;
+            latency.add((uint64_t)chrono::duration_cast<chrono::nanoseconds>(Clock::now() - start).count());
+        }
+        wins += game.state() == WON;
+        moves += (uint64_t)bot.moves();
+        guesses += (uint64_t)bot.guesses();
+    }
+    double seconds = chrono::duration<double>(Clock::now() - t0).count();
+    cout << setw(3) << rows << "x" << setw(3) << left << cols << right << setw(4) << mines << " 雷  " << games << " 局  胜率 " << fixed
+         << setprecision(2) << 100.0 * wins / games << "%  " << setprecision(0) << games / seconds << " 局/秒  平均 " << setprecision(1)
+         << (double)moves / games << " 步、猜 " << setprecision(2) << (double)guesses / games << " 次" << endl;
+    cout << "      每步耗时（微秒）  p50 " << micros(latency.percentile(0.5)) << "  p90 " << micros(latency.percentile(0.9)) << "  p99 "
+         << micros(latency.percentile(0.99)) << "  p99.9 " << micros(latency.percentile(0.999)) << "  最慢 " << micros(latency.maxNs) << endl;
+}
+
+static int playCommand(int argc, char** argv) {
+    uint64_t games = 100000, masterSeed = 1;
+    vector<array<int, 3>> sizes;
+    for (const auto& p : PRESETS) sizes.push_back({p[0], p[1], p[2]});
+    for (int i = 2; i < argc; ++i) {
+        if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            masterSeed = strtoull(argv[++i], nullptr, 16);
+        } else if (!strcmp(argv[i], "--custom") && i + 3 < argc) {
+            int rows = atoi(argv[i + 1]), cols = atoi(argv[i + 2]), mines = atoi(argv[i + 3]);
+            i += 3;
+            if (rows <= 0 || cols <= 0 || mines <= 0 || mines >= rows * cols) {
+                cerr << "自定义难度无效" << endl;
+                return 2;
+            }
+            sizes.push_back({rows, cols, mines});
+        } else if (argv[i][0] != '-' && strtoull(argv[i], nullptr, 10) > 0) {
+            games = strtoull(argv[i], nullptr, 10);
+        } else {
+            return usage();
+        }
+    }
+    char seed[32];
+    snprintf(seed, sizeof(seed), "%016llx", (unsigned long long)masterSeed);
+    cout << "主种子 " << seed << endl;
+    for (const auto& s : sizes) play(s[0], s[1], s[2], games, masterSeed);
+    return 0;
+}
+
+// 一组参数的统计。各线程下完一局直接原子累加，不加锁；都是整数求和，结果与累加顺序无关
+struct SweepPoint {
+    int rows = 0, cols = 0, mines = 0;
+    atomic<uint64_t> wins{0};
+    atomic<uint64_t> clicks{0};
+    atomic<uint64_t> clicksSquared{0};
+    atomic<uint64_t> guesses{0};
+};
+
+// "10"、"8-20" 或 "8-20/4"
+static bool parseRange(const char* s, vector<int>& out) {
+    char* end;
+    long first = strtol(s, &end, 10), last = first, step = 1;
+    if (*end == '-') last = strtol(end + 1, &end, 10);
+    if (*end == '/') step = strtol(end + 1, &end, 10);
+    if (*end != '\0' || first <= 0 || last < first || step <= 0) return false;
+    for (long v = first; v <= last; v += step) out.push_back((int)v);
+    return true;
+}
+
+// 胜率的 95% 置信区间（Wilson 区间，胜率接近 0 或 1 时也可靠）
+static void wilson(uint64_t wins, uint64_t n, double& low, double& high) {
+    const double z = 1.96;
+    double p = (double)wins / n, z2 = z * z / n;
+    double centre = (p + z2 / 2) / (1 + z2), half = z * sqrt(p * (1 - p) / n + z2 / (4 * n)) / (1 + z2);
+    low = max(0.0, centre - half);
+    high = min(1.0, centre + half);
+}
+
+static int sweepCommand(int argc, char** argv) {
+    vector<int> rowValues, colValues, mineValues;
+    bool presets = false;
+    uint64_t games = 10000, masterSeed = 1;
+    int threads = 0;
+    string outPath;
+    int i = 2;
+    if (i < argc && !strcmp(argv[i], "--presets")) {
+        presets = true;
+        i++;
+    } else if (i + 2 < argc) {
+        if (!parseRange(argv[i], rowValues) || !parseRange(argv[i + 1], colValues) || !parseRange(argv[i + 2], mineValues)) return usage();
+        i += 3;
+    } else {
+        return usage();
+    }
+    for (; i < argc; ++i) {
+        if (!strcmp(argv[i], "--games") && i + 1 < argc) {
+            games = strtoull(argv[++i], nullptr, 10);
+        } else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            masterSeed = strtoull(argv[++i], nullptr, 16);
+        } else if (!strcmp(argv[i], "--out") && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            return usage();
+        }
+    }
+    if (games == 0) return usage();
+
+    // 参数组合，雷数放不下的组合跳过
+    vector<array<int, 3>> grid;
+    if (presets) {
+        for (const auto& p : PRESETS) grid.push_back({p[0], p[1], p[2]});
+    } else {
+        for (int r : rowValues) {
+            for (int c : colValues) {
+                for (int m : mineValues) {
+                    if (m < r * c) grid.push_back({r, c, m});
+                }
+            }
+        }
+    }
+    if (grid.empty()) {
+        cerr << "没有有效的参数组合" << endl;
+        return 2;
+    }
+    vector<SweepPoint> points(grid.size());
+    for (size_t p = 0; p < grid.size(); ++p) {
+        points[p].rows = grid[p][0];
+        points[p].cols = grid[p][1];
+        points[p].mines = grid[p][2];
+    }
+
+    // 每个下标是一局：第 index / games 组参数的第 index % games 局，种子为 CounterRng(主种子).at(index % games)
+    WorkStealingPool pool(threads);
+    vector<Game> threadGames(pool.threads());
+    vector<Bot> threadBots(pool.threads());
+    CounterRng seeds(masterSeed);
+    auto t0 = Clock::now();
+    pool.run(grid.size() * games, [&](size_t index, int t) {
+        SweepPoint& p = points[index / games];
+        Game& game = threadGames[t];
+        Bot& bot = threadBots[t];
+        game.createDeferred(p.rows, p.cols, p.mines, seeds.at(index % games));
+        bot.reset();
+        bool won = bot.play(game) == WON;
+        uint64_t clicks = (uint64_t)bot.moves();
+        p.wins.fetch_add(won, memory_order_relaxed);
+        p.clicks.fetch_add(clicks, memory_order_relaxed);
+        p.clicksSquared.fetch_add(clicks * clicks, memory_order_relaxed);
+        p.guesses.fetch_add((uint64_t)bot.guesses(), memory_order_relaxed);
+    });
+    double seconds = chrono::duration<double>(Clock::now() - t0).count();
+
+    ofstream file;
+    if (!outPath.empty()) {
+        file.open(outPath);
+        if (!file) {
+            cerr << "无法创建文件 " << outPath << endl;
+            return 1;
+        }
+    }
+    ostream& out = outPath.empty() ? cout : file;
+    out << "rows,cols,mines,density,games,wins,win_rate,win_ci_low,win_ci_high,mean_clicks,clicks_ci_low,clicks_ci_high,mean_guesses\n";
+    vector<double> winRates;
+    for (const auto& p : points) {
+        uint64_t wins = p.wins.load(), clicks = p.clicks.load(), squared = p.clicksSquared.load();
+        double low, high;
+        wilson(wins, games, low, high);
+        double mean = (double)clicks / games;
+        double variance = games > 1 ? max(0.0, ((double)squared - mean * (double)clicks) / (games - 1)) : 0;
+        double half = 1.96 * sqrt(variance / games);
+        winRates.push_back((double)wins / games);
+        out << p.rows << "," << p.cols << "," << p.mines << "," << fixed << setprecision(4) << (double)p.mines / (p.rows * p.cols) << ","
+            << games << "," << wins << "," << (double)wins / games << "," << low << "," << high << "," << setprecision(3) << mean << ","
+            << mean - half << "," << mean + half << "," << (double)p.guesses.load() / games << "\n";
+        out.unsetf(ios::floatfield);
+    }
+    out.flush();
+    cerr << grid.size() << " 组参数，共 " << grid.size() * games << " 局，" << pool.threads() << " 个线程，用时 " << fixed << setprecision(2)
+         << seconds << " 秒（" << setprecision(0) << grid.size() * games / seconds << " 局/秒）" << endl;
+
+    // 预设的难度应当越高胜率越低
+    if (presets) {
+        bool ordered = true;
+        for (size_t p = 1; p < winRates.size(); ++p) {
+            if (winRates[p] >= winRates[p - 1]) {
+                ordered = false;
+                cerr << "注意：" << PRESET_NAMES[p] << "（" << PRESETS[p][0] << "x" << PRESETS[p][1] << "，" << PRESETS[p][2] << " 雷）胜率 "
+                     << setprecision(1) << winRates[p] * 100 << "%，不低于" << PRESET_NAMES[p - 1] << "的 " << winRates[p - 1] * 100 << "%" << endl;
+            }
+        }
+        if (ordered) cerr << "难度预设的胜率随难度递减" << endl;
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) return usage();
+    string command = argv[1];
+    if (command == "play") return playCommand(argc, argv);
+    if (command == "sweep") return sweepCommand(argc, argv);
+    return usage();
+}
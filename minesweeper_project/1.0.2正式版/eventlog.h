@@ -0,0 +1,377 @@
+#pragma once
+
+// 二进制事件日志。
+//
+// 每个事件是一条变长记录：距上一事件的毫秒数（varint）、1 字节事件类型、按类型而定的参数（varint 或定长）。
+// 事件先追加到内存缓冲区，在对局结束、计时器空闲唤醒或缓冲区满时才写出，按键过程中没有任何文件操作。
+// 日志文件只在程序启动时打开一次，每局追加；文件开头有 8 字节的魔数和版本号。
+// eventText() 把事件转换为以前 minesweeper_log.txt 的文本格式，供日志转换工具使用。
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "boardfile.h"
+#include "metrics.h"
+#include "rice.h"
+
+const char EVENT_LOG_MAGIC[4] = {'S', 'L', 'E', 'V'};
+const uint32_t EVENT_LOG_VERSION = 1;
+
+// 事件类型，注释为参数（LogEvent 中的字段）
+enum EventType {
+    EV_GAME_START = 1, // value = Unix 时间，row/col = 行列数，extra = 雷数，seed
+    EV_LAYOUT,         // blob = Rice 编码的雷位置（种子未知时才有，紧跟 EV_GAME_START）
+    EV_MOVE_UP,
+    EV_MOVE_DOWN,
+    EV_MOVE_LEFT,
+    EV_MOVE_RIGHT,
+    EV_FLAG,           // row, col
+    EV_REVEAL,         // row, col
+    EV_QUIT,           // hash = 退出时棋盘字节的校验和
+    EV_UNKNOWN_KEY,    // value = 扩展键代码
+    EV_INVALID_KEY,    // value = 字符
+    EV_SAVE,           // text = 存档文件名（原样路径，相对路径相对于日志所在目录），保存失败时为空
+    EV_RESUME,         // text = 快照文件名（同上），value = 已用毫秒数
+    EV_GAME_OVER,      // value = 是否获胜，extra = 用时毫秒数，hash = 结束时棋盘字节的校验和
+    EV_LATENCY,        // value = 平均延迟，extra = 最大延迟（单位 0.1 微秒），count = 帧数
+    EV_RENDER,         // count = 帧数，value = 平均每帧字节数
+    EV_CHORD,          // row, col
+    EV_DEFERRED_LAYOUT, // 布局在第一次揭示时按种子生成，避开揭示格周围 3x3（紧跟 EV_GAME_START）
+    EV_NO_GUESS_LAYOUT, // 同上，生成无猜布局
+    EV_HINT,           // row, col = 查看提示时的光标位置，不改变局面
+    EV_METRICS,        // 布局指标（紧跟 EV_GAME_OVER）：value = 3BV，extra = ZiNi，row = 开局区域数，col = 孤岛数，count = 已完成的 3BV
+    EV_TYPE_END
+};
+
+// 棋盘全部字节（雷、数字、状态）的校验和，用于回放时核对结果
+inline uint64_t boardHash(const Board& board) {
+    return fnv1a64(board.data(), (size_t)(board.rows() + 2) * board.stride());
+}
+
+// 写日志：所有事件先写入内存缓冲区
+class EventLog {
+public:
+    EventLog() : file_(nullptr), last_(std::chrono::steady_clock::now()) {}
+    ~EventLog() { close(); }
+
+    // 以追加方式打开，新文件先写入文件头
+    bool open(const std::string& path) {
+        close();
+        file_ = fopen(path.c_str(), "ab");
+        if (!file_) return false;
+        fseek(file_, 0, SEEK_END);
+        if (ftell(file_) == 0) {
+            fwrite(EVENT_LOG_MAGIC, 1, 4, file_);
+            uint8_t version[4] = {(uint8_t)EVENT_LOG_VERSION, 0, 0, 0};
+            fwrite(version, 1, 4, file_);
+        }
+        return true;
+    }
+
+    void close() {
+        if (file_) {
+            flush();
+            fclose(file_);
+            file_ = nullptr;
+        }
+    }
+
+    // 把缓冲区写入文件
+    void flush() {
+        if (file_ && !buf_.empty()) {
+            fwrite(buf_.data(), 1, buf_.size(), file_);
+            fflush(file_);
+        }
+        buf_.clear();
+    }
+
+    void gameStart(uint64_t unixTime, int rows, int cols, int mines, uint64_t seed) {
+        begin(EV_GAME_START);
+        putVarint(unixTime);
+        putVarint((uint64_t)rows);
+        putVarint((uint64_t)cols);
+        putVarint((uint64_t)mines);
+        putFixed64(seed);
+    }
+    void layout(const MineBitmap& bits, int rows, int cols, int mines) {
+        std::vector<uint8_t> encoded;
+        riceEncode(bits, (uint32_t)rows * (uint32_t)cols, (uint32_t)mines, encoded);
+        begin(EV_LAYOUT);
+        putVarint(encoded.size());
+        buf_.insert(buf_.end(), encoded.begin(), encoded.end());
+    }
+    void move(EventType direction) { begin(direction); }
+    void flag(int row, int col) { cell(EV_FLAG, row, col); }
+    void reveal(int row, int col) { cell(EV_REVEAL, row, col); }
+    void chord(int row, int col) { cell(EV_CHORD, row, col); }
+    void hint(int row, int col) { cell(EV_HINT, row, col); }
+    void deferredLayout(bool noGuess) { begin(noGuess ? EV_NO_GUESS_LAYOUT : EV_DEFERRED_LAYOUT); }
+    void quit(uint64_t hash) {
+        begin(EV_QUIT);
+        putFixed64(hash);
+    }
+    void unknownKey(int code) {
+        begin(EV_UNKNOWN_KEY);
+        putVarint((uint64_t)code);
+    }
+    void invalidKey(int ch) {
+        begin(EV_INVALID_KEY);
+        putVarint((uint64_t)(uint8_t)ch);
+    }
+    void save(const std::string& file) {
+        begin(EV_SAVE);
+        putString(file);
+    }
+    void resume(const std::string& file, uint64_t elapsedMs) {
+        begin(EV_RESUME);
+        putString(file);
+        putVarint(elapsedMs);
+    }
+    void gameOver(bool won, uint64_t durationMs, uint64_t hash) {
+        begin(EV_GAME_OVER);
+        putVarint(won ? 1 : 0);
+        putVarint(durationMs);
+        putFixed64(hash);
+    }
+    void latency(double averageUs, double maxUs, long long frames) {
+        begin(EV_LATENCY);
+        putVarint((uint64_t)(averageUs * 10 + 0.5));
+        putVarint((uint64_t)(maxUs * 10 + 0.5));
+        putVarint((uint64_t)frames);
+    }
+    void metrics(const BoardMetrics& m, int solvedBbbv) {
+        begin(EV_METRICS);
+        putVarint((uint64_t)m.bbbv);
+        putVarint((uint64_t)m.zini);
+        putVarint((uint64_t)m.openings);
+        putVarint((uint64_t)m.islands);
+        putVarint((uint64_t)solvedBbbv);
+    }
+    void render(long long frames, long long averageBytes) {
+        begin(EV_RENDER);
+        putVarint((uint64_t)frames);
+        putVarint((uint64_t)averageBytes);
+    }
+
+    // 缓冲区中尚未写出的字节数
+    size_t pending() const { return buf_.size(); }
+
+private:
+    EventLog(const EventLog&);
+    EventLog& operator=(const EventLog&);
+
+    // 缓冲区超过这个大小时在下一条事件前写出，避免超长对局占用过多内存
+    static const size_t FLUSH_THRESHOLD = 1 << 16;
+
+    void begin(EventType type) {
+        if (buf_.size() >= FLUSH_THRESHOLD) flush();
+        auto now = std::chrono::steady_clock::now();
+        putVarint((uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(now - last_).count());
+        last_ = now;
+        buf_.push_back((uint8_t)type);
+    }
+    void cell(EventType type, int row, int col) {
+        begin(type);
+        putVarint((uint64_t)row);
+        putVarint((uint64_t)col);
+    }
+    void putVarint(uint64_t v) {
+        while (v >= 0x80) {
+            buf_.push_back((uint8_t)(v | 0x80));
+            v >>= 7;
+        }
+        buf_.push_back((uint8_t)v);
+    }
+    void putFixed64(uint64_t v) {
+        for (int i = 0; i < 8; ++i) buf_.push_back((uint8_t)(v >> (8 * i)));
+    }
+    void putString(const std::string& s) {
+        putVarint(s.size());
+        buf_.insert(buf_.end(), s.begin(), s.end());
+    }
+
+    FILE* file_;
+    std::vector<uint8_t> buf_;
+    std::chrono::steady_clock::time_point last_;
+};
+
+// 读出的一条事件，字段含义见 EventType
+struct LogEvent {
+    EventType type = EV_TYPE_END;
+    uint64_t timeMs = 0; // 距日志开头（各条记录的间隔累加）的毫秒数
+    uint64_t deltaMs = 0; // 距上一条事件的毫秒数
+    int row = 0;
+    int col = 0;
+    uint64_t value = 0;
+    uint64_t extra = 0;
+    uint64_t count = 0;
+    uint64_t seed = 0;
+    uint64_t hash = 0;
+    std::string text;
+    std::vector<uint8_t> blob;
+};
+
+// 顺序读取内存中的日志（例如映射的文件）
+class EventReader {
+public:
+    EventReader(const uint8_t* data, size_t size) : p_(data), end_(data + size), timeMs_(0), error_(false) {
+        valid_ = size >= 8 && memcmp(data, EVENT_LOG_MAGIC, 4) == 0 && data[4] == EVENT_LOG_VERSION;
+        if (valid_) p_ += 8;
+    }
+
+    bool valid() const { return valid_; }
+    // 读到末尾前遇到无法解析的数据
+    bool error() const { return error_; }
+
+    // 读出下一条事件，读完或出错时返回 false
+    bool next(LogEvent& e) {
+        if (!valid_ || error_ || p_ >= end_) return false;
+        uint64_t delta, type;
+        if (!getVarint(delta) || p_ >= end_ || (type = *p_++) == 0 || type >= EV_TYPE_END) {
+            return fail();
+        }
+        e = LogEvent();
+        e.type = (EventType)type;
+        e.deltaMs = delta;
+        timeMs_ += delta;
+        e.timeMs = timeMs_;
+        uint64_t a = 0, b = 0;
+        bool ok = true;
+        switch (e.type) {
+            case EV_GAME_START:
+                ok = getVarint(e.value) && getVarint(a) && getVarint(b) && getVarint(e.extra) && getFixed64(e.seed);
+                e.row = (int)a;
+                e.col = (int)b;
+                break;
+            case EV_LAYOUT:
+                ok = getVarint(a) && a <= (uint64_t)(end_ - p_);
+                if (ok) {
+                    e.blob.assign(p_, p_ + a);
+                    p_ += a;
+                }
+                break;
+            case EV_FLAG:
+            case EV_REVEAL:
+            case EV_CHORD:
+            case EV_HINT:
+                ok = getVarint(a) && getVarint(b);
+                e.row = (int)a;
+                e.col = (int)b;
+                break;
+            case EV_QUIT:
+                ok = getFixed64(e.hash);
+                break;
+            case EV_UNKNOWN_KEY:
+            case EV_INVALID_KEY:
+                ok = getVarint(e.value);
+                break;
+            case EV_SAVE:
+                ok = getString(e.text);
+                break;
+            case EV_RESUME:
+                ok = getString(e.text) && getVarint(e.value);
+                break;
+            case EV_GAME_OVER:
+                ok = getVarint(e.value) && getVarint(e.extra) && getFixed64(e.hash);
+                break;
+            case EV_LATENCY:
+                ok = getVarint(e.value) && getVarint(e.extra) && getVarint(e.count);
+                break;
+            case EV_RENDER:
+                ok = getVarint(e.count) && getVarint(e.value);
+                break;
+            case EV_METRICS:
+                ok = getVarint(e.value) && getVarint(e.extra) && getVarint(a) && getVarint(b) && getVarint(e.count);
+                e.row = (int)a;
+                e.col = (int)b;
+                break;
+            default:
+                break; // 方向键没有参数
+        }
+        return ok ? true : fail();
+    }
+
+private:
+    bool fail() {
+        error_ = true;
+        return false;
+    }
+    bool getVarint(uint64_t& v) {
+        v = 0;
+        for (int shift = 0; shift < 64 && p_ < end_; shift += 7) {
+            uint8_t byte = *p_++;
+            v |= (uint64_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+    bool getFixed64(uint64_t& v) {
+        if (end_ - p_ < 8) return false;
+        v = 0;
+        for (int i = 0; i < 8; ++i) v |= (uint64_t)p_[i] << (8 * i);
+        p_ += 8;
+        return true;
+    }
+    bool getString(std::string& s) {
+        uint64_t n;
+        if (!getVarint(n) || n > (uint64_t)(end_ - p_)) return false;
+        s.assign((const char*)p_, (size_t)n);
+        p_ += n;
+        return true;
+    }
+
+    const uint8_t* p_;
+    const uint8_t* end_;
+    uint64_t timeMs_;
+    bool valid_;
+    bool error_;
+};
+
+// 转换为文本日志的行（含换行符）
+inline std::string eventText(const LogEvent& e) {
+    std::ostringstream out;
+    switch (e.type) {
+        case EV_GAME_START: {
+            char seed[32];
+            snprintf(seed, sizeof(seed), "%016llx", (unsigned long long)e.seed);
+            out << "New Game Started at: " << e.value << "\n";
+            out << "Seed: " << seed << " (" << e.row << "x" << e.col << ", " << e.extra << " mines)\n";
+            break;
+        }
+        case EV_LAYOUT: out << "Layout: embedded, " << e.blob.size() << " bytes\n"; break;
+        case EV_DEFERRED_LAYOUT: out << "Layout: generated on first reveal\n"; break;
+        case EV_NO_GUESS_LAYOUT: out << "Layout: no-guess, generated on first reveal\n"; break;
+        case EV_MOVE_UP: out << "Input: Up\n"; break;
+        case EV_MOVE_DOWN: out << "Input: Down\n"; break;
+        case EV_MOVE_LEFT: out << "Input: Left\n"; break;
+        case EV_MOVE_RIGHT: out << "Input: Right\n"; break;
+        case EV_FLAG: out << "Input: Flag/Unflag at: " << e.row << " " << e.col << "\n"; break;
+        case EV_REVEAL: out << "Input: Reveal at: " << e.row << " " << e.col << "\n"; break;
+        case EV_CHORD: out << "Input: Chord at: " << e.row << " " << e.col << "\n"; break;
+        case EV_HINT: out << "Input: Hint at: " << e.row << " " << e.col << "\n"; break;
+        case EV_QUIT: out << "Input: Game Ended by User.\n"; break;
+        case EV_UNKNOWN_KEY: out << "Input: Unknown extended key: " << e.value << "\n"; break;
+        case EV_INVALID_KEY: out << "Input: " << (char)e.value << " is invalid.\n"; break;
+        case EV_SAVE:
+            out << "Input: Save\n";
+            if (!e.text.empty()) out << "Game Saved to: " << e.text << "\n";
+            break;
+        case EV_RESUME: out << "Game Resumed from " << e.text << ". Elapsed: " << e.value / 1000.0 << "s\n"; break;
+        case EV_GAME_OVER: out << "Game Over (" << (e.value ? "Won" : "Lost") << "). Time: " << e.extra / 1000.0 << "s\n"; break;
+        case EV_LATENCY:
+            out << "Input latency: avg " << e.value / 10.0 << "us, max " << e.extra / 10.0 << "us, frames " << e.count << "\n";
+            break;
+        case EV_RENDER: out << "Render: frames " << e.count << ", avg " << e.value << " bytes/frame\n"; break;
+        case EV_METRICS:
+            out << "Board: 3BV " << e.value << " (openings " << e.row << ", islands " << e.col << "), ZiNi " << e.extra << ", solved 3BV " << e.count
+                << "\n";
+            break;
+        default: break;
+    }
+    return out.str();
+}
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "board.h"
+#include "generator.h"
+#include "metrics.h"
+#include "solver.h"
+
+// 对局状态
+enum GameState { PLAYING, WON, LOST };
+
+// 一局扫雷的全部状态和规则：开局、揭示、标记、双击（chord）和状态查询。
+// 不做任何输入输出，也不使用全局变量；控制台程序只是它的一个客户端，
+// 同一进程里可以同时驱动任意多个互不影响的 Game。
+class Game {
+public:
+    Game() : state_(PLAYING), pendingMines_(0), seed_(0), noGuess_(false), safeRow_(-1), safeCol_(-1) {}
+
+    // 按给定的雷位置开局
+    void create(int rows, int cols, const std::vector<std::pair<int, int>>& minePositions) {
+        minePositions_ = minePositions;
+        board_.reset(rows, cols);
+        for (const auto& pos : minePositions_) {
+            board_.setMine(board_.index(pos.first, pos.second));
+        }
+        board_.computeAdjacency();
+        revealed_.clear();
+        state_ = PLAYING;
+        pendingMines_ = 0;
+        noGuess_ = false;
+        safeRow_ = safeCol_ = -1;
+    }
+
+    // 延迟开局：先不放雷，第一次揭示时才按种子生成避开该格周围 3x3 的布局（见 generateMinesAvoiding），
+    // 开局不需要等待生成，第一次揭示也不会踩雷。noGuess 时生成无猜布局（见 generateNoGuess）。
+    // 生成之前可以插旗，旗子保留
+    void createDeferred(int rows, int cols, int mines, uint64_t seed, bool noGuess = false) {
+        create(rows, cols, {});
+        board_.setPendingMines(mines);
+        pendingMines_ = mines;
+        seed_ = seed;
+        noGuess_ = noGuess;
+    }
+
+    // 布局尚未生成
+    bool pending() const { return pendingMines_ > 0; }
+
+    // 立即按种子生成布局，不避开任何格子，与 generateMines(seed) 相同（开局前保存时需要确定布局）。
+    // 无猜布局依赖第一次揭示的格子，这里生成的是普通布局，noGuess() 随之变为 false
+    void generateNow() {
+        if (pending()) {
+            applyLayout(generateMines((uint32_t)board_.cellCount(), (uint32_t)pendingMines_, seed_));
+            noGuess_ = false;
+        }
+    }
+
+    // 按无猜模式开局，且布局生成后确实不需要猜
+    bool noGuess() const { return noGuess_; }
+
+    // 布局避开的第一次揭示的格子；不是延迟生成的布局时为 -1
+    int safeRow() const { return safeRow_; }
+    int safeCol() const { return safeCol_; }
+
+    // 揭示一个格子，返回 false 表示踩到雷。越界、已揭示、已标记或对局已结束时什么也不做
+    bool reveal(int row, int col) {
+        revealed_.clear();
+        if (state_ != PLAYING || !board_.inside(row, col)) {
+            return true;
+        }
+        if (pending() && board_.statusAt(board_.index(row, col)) == HIDDEN) {
+            MineBitmap bits;
+            if (noGuess_) {
+                noGuess_ = generateNoGuess(board_.rows(), board_.cols(), (uint32_t)pendingMines_, seed_, row, col, bits);
+            } else {
+                bits = generateMinesAvoiding(board_.rows(), board_.cols(), (uint32_t)pendingMines_, seed_, row, col);
+            }
+            applyLayout(bits);
+            safeRow_ = row;
+            safeCol_ = col;
+        }
+        if (!board_.reveal(board_.index(row, col), revealed_)) {
+            state_ = LOST;
+            return false;
+        }
+        updateWin();
+        return true;
+    }
+
+    // 切换标记，返回切换后的状态
+    CellStatus toggleFlag(int row, int col) {
+        revealed_.clear();
+        if (state_ != PLAYING || !board_.inside(row, col)) {
+            return HIDDEN;
+        }
+        CellStatus s = board_.toggleFlag(board_.index(row, col));
+        updateWin();
+        return s;
+    }
+
+    // 双击：已揭示的数字格周围的旗数等于数字时，揭示它周围所有未标记的格子。
+    // 8 个邻居作为一次多源揭示（Board::revealBatch），连通的空白区域只展开一遍。
+    // 返回 false 表示旗插错导致踩雷；条件不满足时什么也不做
+    bool chord(int row, int col) {
+        revealed_.clear();
+        if (state_ != PLAYING || !board_.inside(row, col)) {
+            return true;
+        }
+        int idx = board_.index(row, col);
+        int number = board_.adjacent(idx);
+        if (board_.statusAt(idx) != REVEALED || number == 0) {
+            return true;
+        }
+        const int* nb = board_.neighbours();
+        int flags = 0;
+        for (int k = 0; k < 8; ++k) {
+            flags += board_.statusAt(idx + nb[k]) == FLAGGED;
+        }
+        if (flags != number) {
+            return true;
+        }
+        int sources[8];
+        for (int k = 0; k < 8; ++k) {
+            sources[k] = idx + nb[k];
+        }
+        if (!board_.revealBatch(sources, 8, revealed_)) {
+            state_ = LOST;
+            return false;
+        }
+        updateWin();
+        return true;
+    }
+
+    // 按快照文件中的状态位平面恢复存档的对局进度：planes 中每 64 格依次是已揭示字和已标记字（小端，
+    // 见 Board::statusWords），words 为组数，逐字从 planes 读出直接写入棋盘。
+    // 已揭示的格子里有雷说明存档不是进行中的对局，返回 false
+    bool restoreStatus(const uint8_t* planes, size_t words) {
+        revealed_.clear();
+        for (size_t w = 0; w < words; ++w) {
+            uint64_t revealed, flagged;
+            memcpy(&revealed, planes + w * 16, 8);
+            memcpy(&flagged, planes + w * 16 + 8, 8);
+            board_.setStatusWords(w, revealed, flagged);
+        }
+        board_.recount();
+        const uint8_t revealedMine = Board::MINE_BIT | Board::REVEALED_BITS;
+        bool exploded = false;
+        for (int i = 0; i < board_.rows(); ++i) {
+            const uint8_t* r = board_.row(i);
+            for (int j = 0; j < board_.cols(); ++j) {
+                exploded |= (r[j] & (Board::MINE_BIT | Board::STATUS_MASK)) == revealedMine;
+            }
+        }
+        if (exploded) {
+            return false;
+        }
+        state_ = PLAYING;
+        updateWin();
+        return true;
+    }
+
+    GameState state() const { return state_; }
+    bool finished() const { return state_ != PLAYING; }
+
+    const Board& board() const { return board_; }
+    BoardStats stats() const { return board_.stats(); }
+    int rows() const { return board_.rows(); }
+    int cols() const { return board_.cols(); }
+    const std::vector<std::pair<int, int>>& minePositions() const { return minePositions_; }
+
+    // 布局的 3BV、开局区域数等指标（见 metrics.h）；布局尚未生成时全为 0。
+    // 每次调用都扫描整个棋盘（与格子数成正比），只在需要时（如结束时）调用，不拖慢开局和第一次揭示
+    BoardMetrics metrics() const { return pending() ? BoardMetrics() : computeBoardMetrics(board_); }
+
+    // 最近一次操作新揭示的格子（Board 下标），按揭示顺序排列
+    const std::vector<int>& lastRevealed() const { return revealed_; }
+
+private:
+    // 在已有的格子状态（生成前插的旗）上放雷，重新计算数字和统计
+    void applyLayout(const MineBitmap& bits) {
+        minePositions_ = bitmapToPositions(bits, board_.cols());
+        for (const auto& pos : minePositions_) {
+            board_.setMine(board_.index(pos.first, pos.second));
+        }
+        board_.computeAdjacency();
+        board_.recount();
+        pendingMines_ = 0;
+    }
+
+    // 两种获胜条件：所有非雷格子都已揭示，或所有雷都被正确标记。布局生成之前不判断
+    void updateWin() {
+        if (pending()) {
+            return;
+        }
+        if (board_.hiddenSafe() == 0 || board_.correctFlags() == board_.mineCount()) {
+            state_ = WON;
+        }
+    }
+
+    Board board_;
+    GameState state_;
+    std::vector<int> revealed_;
+    std::vector<std::pair<int, int>> minePositions_;
+    int pendingMines_; // 延迟生成时尚未放置的雷数
+    uint64_t seed_;
+    bool noGuess_;
+    int safeRow_;
+    int safeCol_;
+};
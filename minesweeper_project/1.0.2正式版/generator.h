@@ -0,0 +1,187 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// 棋盘生成：雷位置的随机抽取
+
+// 位图，每格 1 位，格子编号为 row * cols + col
+typedef std::vector<uint64_t> MineBitmap;
+
+inline bool testBit(const MineBitmap& bits, uint64_t i) { return (bits[i >> 6] >> (i & 63)) & 1; }
+inline void setBit(MineBitmap& bits, uint64_t i) { bits[i >> 6] |= (uint64_t)1 << (i & 63); }
+
+// 最低位 1 的位置，x 不能为 0
+inline int lowestBit(uint64_t x) {
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return (int)i;
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+// 1 的个数
+inline int popcount64(uint64_t x) {
+#ifdef _MSC_VER
+    // __popcnt64 需要 CPU 支持 POPCNT 指令，这里用不依赖指令集的写法
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (int)((x * 0x0101010101010101ULL) >> 56);
+#else
+    return __builtin_popcountll(x);
+#endif
+}
+
+// [0, n) 内均匀分布的随机整数（Lemire 乘法取高位，带无偏修正），gen() 需返回 32 位随机数
+template <class Rng>
+inline uint32_t randomBelow(Rng& gen, uint32_t n) {
+    uint64_t m = (uint64_t)(uint32_t)gen() * n;
+    uint32_t low = (uint32_t)m;
+    if (low < n) {
+        uint32_t threshold = (0u - n) % n;
+        while (low < threshold) { // 概率极小，只为消除取模偏差
+            m = (uint64_t)(uint32_t)gen() * n;
+            low = (uint32_t)m;
+        }
+    }
+    return (uint32_t)(m >> 32);
+}
+
+// 计数器式随机数发生器：第 i 个输出只由 (seed, i) 决定，是 SplitMix64 第 i 步的结果。
+// 没有内部状态表，构造和跳转都是 O(1)；同一个 64 位种子在任何平台上都生成同样的序列，
+// 布局可以只凭 (行数, 列数, 雷数, 种子) 重新生成
+class CounterRng {
+public:
+    typedef uint32_t result_type;
+
+    explicit CounterRng(uint64_t seed, uint64_t counter = 0) : seed_(seed), counter_(counter) {}
+
+    static uint64_t mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // 第 i 个 64 位输出
+    uint64_t at(uint64_t i) const { return mix(seed_ + (i + 1) * 0x9E3779B97F4A7C15ULL); }
+
+    uint64_t next64() { return at(counter_++); }
+    uint32_t operator()() { return (uint32_t)(next64() >> 32); }
+
+    static constexpr uint32_t min() { return 0; }
+    static constexpr uint32_t max() { return 0xFFFFFFFFu; }
+
+private:
+    uint64_t seed_;
+    uint64_t counter_;
+};
+
+// 从 cellCount 个格子中均匀随机选出 count 个不同的格子，写入 bits。
+// 使用 Floyd 抽样：恰好 count 次随机数，抽中已选格子时改选当前上界，没有碰撞重试。
+template <class Rng>
+inline void floydSample(uint32_t cellCount, uint32_t count, Rng& gen, MineBitmap& bits) {
+    for (uint32_t j = cellCount - count; j < cellCount; ++j) {
+        uint32_t t = randomBelow(gen, j + 1);
+        if (testBit(bits, t)) {
+            setBit(bits, j);
+        } else {
+            setBit(bits, t);
+        }
+    }
+}
+
+// 均匀随机放置 mines 个雷，返回雷位图。
+// 随机数开销为 O(min(mines, cellCount - mines))：雷密度超过一半时改为抽取安全格再整体取反，
+// 85% 的高密度棋盘只需抽 15% 的格子。
+template <class Rng>
+inline MineBitmap placeMines(uint32_t cellCount, uint32_t mines, Rng& gen) {
+    MineBitmap bits((cellCount + 63) / 64, 0);
+    if (mines * 2 <= cellCount) {
+        floydSample(cellCount, mines, gen, bits);
+        return bits;
+    }
+    floydSample(cellCount, cellCount - mines, gen, bits);
+    for (auto& w : bits) {
+        w = ~w;
+    }
+    if (cellCount % 64) {
+        bits.back() &= ((uint64_t)1 << (cellCount % 64)) - 1; // 清掉末尾多余的位
+    }
+    return bits;
+}
+
+// 新的随机种子，不为 0（0 在 .sl 文件和日志中表示种子未知）
+inline uint64_t randomSeed() {
+    std::random_device rd;
+    uint64_t seed;
+    do {
+        seed = ((uint64_t)rd() << 32) ^ rd();
+    } while (seed == 0);
+    return seed;
+}
+
+// 由种子确定的布局。这里的算法（CounterRng + placeMines）一旦改变，旧的种子就会生成不同的布局，
+// 只记录种子的 .sl 文件也会失效
+inline MineBitmap generateMines(uint32_t cellCount, uint32_t mines, uint64_t seed) {
+    CounterRng rng(seed);
+    return placeMines(cellCount, mines, rng);
+}
+
+// 在第 pos 位插入 count 个 0，pos 及之后的位整体后移，超出 bits 末尾的位丢弃
+inline void insertZeroBits(MineBitmap& bits, uint64_t pos, int count) {
+    size_t w = (size_t)(pos >> 6);
+    if (count <= 0 || w >= bits.size()) return;
+    uint64_t low = ((uint64_t)1 << (pos & 63)) - 1; // pos 之前、保持不动的位
+    for (size_t i = bits.size() - 1; i > w; --i) {
+        uint64_t carry = i - 1 == w ? bits[i - 1] & ~low : bits[i - 1];
+        bits[i] = (bits[i] << count) | (carry >> (64 - count));
+    }
+    bits[w] = (bits[w] & low) | ((bits[w] & ~low) << count);
+}
+
+// 由种子确定、避开 (safeRow, safeCol) 周围 3x3 的布局，第一次揭示必定是空白格。
+// 去掉这些格子后剩下的格子重新连续编号，在上面做一次 placeMines，再把编号映射回棋盘：
+// 被避开的格子每行最多连续 3 个，在位图中这些位置插入 0 即可，不需要重试。
+// 雷太多放不下时只避开点击的格子本身
+inline MineBitmap generateMinesAvoiding(int rows, int cols, uint32_t mines, uint64_t seed, int safeRow, int safeCol) {
+    uint32_t cellCount = (uint32_t)rows * (uint32_t)cols;
+    int r0 = std::max(safeRow - 1, 0), r1 = std::min(safeRow + 1, rows - 1);
+    int c0 = std::max(safeCol - 1, 0), c1 = std::min(safeCol + 1, cols - 1);
+    if ((uint32_t)((r1 - r0 + 1) * (c1 - c0 + 1)) > cellCount - mines) {
+        r0 = r1 = safeRow;
+        c0 = c1 = safeCol;
+    }
+    int width = c1 - c0 + 1;
+    uint32_t excluded = (uint32_t)((r1 - r0 + 1) * width);
+    CounterRng rng(seed);
+    MineBitmap bits = placeMines(cellCount - excluded, mines, rng);
+    bits.resize((cellCount + 63) / 64, 0);
+    for (int r = r0; r <= r1; ++r) { // 按编号从小到大插入，每次插入的位置都是最终棋盘上的编号
+        insertZeroBits(bits, (uint64_t)r * cols + c0, width);
+    }
+    return bits;
+}
+
+// 雷位图转为 (行, 列) 列表，按行优先顺序
+inline std::vector<std::pair<int, int>> bitmapToPositions(const MineBitmap& bits, int cols) {
+    std::vector<std::pair<int, int>> positions;
+    for (size_t w = 0; w < bits.size(); ++w) {
+        uint64_t word = bits[w];
+        while (word) {
+            uint64_t i = w * 64 + lowestBit(word);
+            positions.push_back({(int)(i / cols), (int)(i % cols)});
+            word &= word - 1;
+        }
+    }
+    return positions;
+}
@@ -0,0 +1,156 @@
+// 事件日志工具
+//
+//   logtool text [日志文件]            把二进制事件日志转换为文本，输出到标准输出
+//   logtool replay [日志文件] [倍速]   重新执行日志中的每一局并核对结果；给出倍速时按记录的时间间隔显示回放画面
+//
+// 日志文件默认为 minesweeper_log.bin。编译：g++ -O2 -std=c++17 logtool.cpp -o logtool
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "boardfile.h"
+#include "eventlog.h"
+#include "renderer.h"
+#include "replay.h"
+#include "terminal.h"
+
+using namespace std;
+
+static int usage() {
+    cerr << "用法：logtool text [日志文件]" << endl;
+    cerr << "      logtool replay [日志文件] [倍速]" << endl;
+    return 2;
+}
+
+// 映射日志文件，失败时输出错误
+static bool openLog(const string& path, MappedFile& file) {
+    if (!file.open(path)) {
+        cerr << "无法打开日志文件 " << path << endl;
+        return false;
+    }
+    EventReader reader(file.data(), file.size());
+    if (!reader.valid()) {
+        cerr << path << " 不是事件日志文件" << endl;
+        return false;
+    }
+    return true;
+}
+
+static int toText(const string& path) {
+    MappedFile file;
+    if (!openLog(path, file)) return 1;
+    EventReader reader(file.data(), file.size());
+    LogEvent e;
+    string out;
+    uint64_t durationMs = 0; // 本局 EV_GAME_OVER 记录的用时，用于计算 3BV/s
+    while (reader.next(e)) {
+        out += eventText(e);
+        if (e.type == EV_GAME_START) durationMs = 0;
+        if (e.type == EV_GAME_OVER) durationMs = e.extra;
+        if (e.type == EV_METRICS && durationMs > 0) {
+            char rate[64];
+            snprintf(rate, sizeof(rate), "3BV/s: %.2f\n", e.count * 1000.0 / durationMs);
+            out += rate;
+        }
+        if (out.size() >= (1 << 16)) {
+            fwrite(out.data(), 1, out.size(), stdout);
+            out.clear();
+        }
+    }
+    fwrite(out.data(), 1, out.size(), stdout);
+    if (reader.error()) {
+        cerr << "日志文件在末尾之前损坏，之后的事件已忽略" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+static const char* endText(ReplayEnd end) {
+    switch (end) {
+        case REPLAY_WON: return "获胜";
+        case REPLAY_LOST: return "踩雷";
+        case REPLAY_QUIT: return "退出";
+        default: return "未结束";
+    }
+}
+
+// 日志所在目录，快照文件与日志保存在同一目录
+static string directoryOf(const string& path) {
+    size_t slash = path.find_last_of("/\\");
+    return slash == string::npos ? "" : path.substr(0, slash);
+}
+
+// speed 为 0 时不显示画面，以最快速度回放
+static int replay(const string& path, double speed) {
+    MappedFile file;
+    if (!openLog(path, file)) return 1;
+    EventReader reader(file.data(), file.size());
+    Replayer replayer(directoryOf(path));
+    Renderer renderer;
+    if (speed > 0) terminalInit();
+    LogEvent e;
+    long long events = 0;
+    uint64_t gameStartMs = 0;
+    auto t0 = chrono::steady_clock::now();
+    while (reader.next(e)) {
+        events++;
+        if (speed > 0) {
+            // 两局之间可能隔了很久，最多等 2 秒
+            long long waitMs = min((long long)(e.deltaMs / speed), 2000LL);
+            if (waitMs > 0) this_thread::sleep_for(chrono::milliseconds(waitMs));
+            if (e.type == EV_GAME_START) {
+                gameStartMs = e.timeMs;
+                renderer.invalidate();
+            }
+        }
+        bool changed = replayer.apply(e);
+        if (speed > 0 && (changed || e.type == EV_GAME_OVER)) {
+            const Game& game = replayer.game();
+            renderer.draw(game.board(), game.finished(), (e.timeMs - gameStartMs) / 1000.0, replayer.cursorRow(), replayer.cursorCol());
+        }
+    }
+    replayer.finish();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    long long actions = 0, verified = 0, failed = 0, unfinished = 0;
+    const vector<ReplayResult>& results = replayer.results();
+    for (size_t i = 0; i < results.size(); ++i) {
+        const ReplayResult& r = results[i];
+        actions += r.actions;
+        if (r.verified) {
+            verified++;
+        } else if (r.end == REPLAY_UNFINISHED) {
+            unfinished++;
+        } else {
+            failed++;
+        }
+        if (!r.verified) {
+            cout << "第 " << i + 1 << " 局（" << r.rows << "x" << r.cols << "，" << r.mines << " 雷，" << endText(r.end) << "）：" << r.error << endl;
+        }
+    }
+    cout << results.size() << " 局：" << verified << " 局一致，" << failed << " 局不一致，" << unfinished << " 局无法核对" << endl;
+    cout << events << " 个事件，" << actions << " 次揭示/标记/双击，用时 " << fixed << setprecision(3) << seconds * 1000 << " 毫秒";
+    if (speed <= 0 && seconds > 0) {
+        cout << "（" << setprecision(2) << actions / seconds / 1e6 << " 百万次操作/秒）";
+    }
+    cout << endl;
+    if (reader.error()) {
+        cerr << "日志文件在末尾之前损坏，之后的事件已忽略" << endl;
+        return 1;
+    }
+    return failed ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) return usage();
+    string command = argv[1];
+    string path = argc >= 3 ? argv[2] : "minesweeper_log.bin";
+    if (command == "text") return toText(path);
+    if (command == "replay") return replay(path, argc >= 4 ? atof(argv[3]) : 0);
+    return usage();
+}
@@ -1,21 +1,25 @@
 #include <iostream>
 #include <vector>
 #include <random>
+#include <cerrno>
 #include <ctime>
 #include <chrono>
 #include <thread>
 #include <iomanip>
-#include <conio.h>
 #include <limits>
 #include <fstream>
 #include <sstream>
 #include <string>
 #include <algorithm>
-#include <chrono>
+#include <cstdlib>
 
-#ifdef _WIN32
-#include <windows.h>
-#endif
+#include "analyzer.h"
+#include "boardfile.h"
+#include "eventlog.h"
+#include "game.h"
+#include "generator.h"
+#include "renderer.h"
+#include "terminal.h"
 
 using namespace std;
 
@@ -24,59 +28,48 @@ int ROWS;
 int COLS;
 int MINES;
 
-// 单元格状态
-enum CellStatus { HIDDEN, REVEALED, FLAGGED };
-
-// 颜色定义 (ANSI 转义序列)
-const string COLOR_RESET = "\x1b[0m";
-const string COLOR_HIDDEN = "\x1b[37m";
-const string COLOR_REVEALED = "\x1b[32m";
-const string COLOR_FLAGGED = "\x1b[31m";
-const string COLOR_MINE = "\x1b[91m";
-const string COLOR_TIME = "\x1b[33m";
-
-// 棋盘和状态（动态分配）
-vector<vector<int>> board;
-vector<vector<CellStatus>> status;
+// 当前对局（规则和棋盘状态见 game.h，本文件只负责控制台交互）
+Game game;
+Renderer renderer; // 差分渲染器，保存上一帧画面
 vector<pair<int, int>> minePositions;
+uint64_t boardSeed = 0;   // 当前布局的随机种子，0 表示未知（从不带种子的文件加载）
+bool seedEntered = false; // 玩家输入了种子，下一局按这个种子生成
+bool boardLoaded = false; // 布局刚从文件加载，下一局直接使用，不重新生成
+bool noGuessMode = false; // 新的一局生成无猜布局（见 solver.h）
+BoardLayout loadedSnapshot; // 从快照文件加载时保存的对局进度，开局后恢复
+string loadedFilename;      // 最近加载的 .sl 文件名，恢复快照时记入日志
+
+// 种子显示为 16 位十六进制，方便抄写和分享
+string seedText(uint64_t seed) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%016llx", (unsigned long long)seed);
+    return buf;
+}
 
-
-
-#ifdef _WIN32
-void enableVirtualTerminalProcessing() {
-    HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
-    if (hOut != INVALID_HANDLE_VALUE) {
-        DWORD dwMode = 0;
-        if (GetConsoleMode(hOut, &dwMode)) {
-            dwMode |= ENABLE_VIRTUAL_TERMINAL_PROCESSING;
-            SetConsoleMode(hOut, dwMode);
-        }
-    }
+// 以当前时间命名存档文件，例如 20250124141500
+string timestampName() {
+    time_t rawtime;
+    time(&rawtime);
+    char buffer[80];
+    strftime(buffer, sizeof(buffer), "%Y%m%d%H%M%S", localtime(&rawtime));
+    return buffer;
 }
-#else
-void enableVirtualTerminalProcessing() {}
-#endif
-
-bool saveBoardToFile(const string& filename, int ROWS, int COLS, int MINES, const std::vector<std::pair<int, int>>& minePositions) {
-    ofstream outfile(filename + ".sl"); // 添加 .sl 后缀
-    if (!outfile.is_open()) {
-        cerr << "无法创建文件 " << filename << ".sl" << endl;
-        return false;
-    }
 
-    outfile << ROWS << " " << COLS << " " << MINES << endl; // 写入棋盘信息
-    for (const auto& pos : minePositions) {
-        outfile << pos.first << " " << pos.second << endl; // 写入雷的位置
+// 保存为第 2 版二进制格式（见 boardfile.h），位图和压缩编码中取较小的一种
+bool saveBoardToFile(const string& filename, int ROWS, int COLS, const std::vector<std::pair<int, int>>& minePositions) {
+    BoardLayout layout = layoutFromPositions(ROWS, COLS, minePositions, boardSeed);
+    string error;
+    if (!saveBoardBinary(filename + ".sl", layout, error, smallestEncoding(layout))) { // 添加 .sl 后缀
+        cerr << error << endl;
+        return false;
     }
-
-    outfile.close();
     cout << "棋盘已保存到 " << filename << ".sl" << endl;
-    system("PAUSE");
+    pauseForKey();
     return true;
 }
 
 
-// 加载棋盘布局从文件
+// 加载棋盘布局从文件，二进制和旧版文本格式都可以读取
 bool loadBoardFromFile(const string& filename, int& ROWS, int& COLS, int& MINES) {
     // 检查文件后缀
     string lowerFilename = filename;
@@ -86,285 +79,240 @@ bool loadBoardFromFile(const string& filename, int& ROWS, int& COLS, int& MINES)
         return false;
     }
 
-    ifstream infile(filename);
-    if (!infile.is_open()) {
-        cerr << "无法打开文件 " << filename << endl;
-        return false;
-    }
-
-    if (!(infile >> ROWS >> COLS >> MINES)) {
-        cerr << "文件格式错误！" << endl;
+    BoardLayout layout;
+    string error;
+    if (!loadBoardFile(filename, layout, error)) {
+        cerr << error << endl;
         return false;
     }
 
-    board.assign(ROWS, vector<int>(COLS, 0));
-    status.assign(ROWS, vector<CellStatus>(COLS, HIDDEN));
-    minePositions.clear();
-
-    for (int i = 0; i < MINES; ++i) {
-        int row, col;
-        if (!(infile >> row >> col) || row < 0 || row >= ROWS || col < 0 || col >= COLS) {
-            cerr << "文件格式错误或雷的位置超出范围！" << endl;
-            return false;
-        }
-        board[row][col] = -1;
-        minePositions.push_back({row, col});
-    }
-
-    for (int i = 0; i < ROWS; ++i) {
-        for (int j = 0; j < COLS; ++j) {
-            if (board[i][j] != -1) {
-                int count = 0;
-                for (int x = -1; x <= 1; ++x) {
-                    for (int y = -1; y <= 1; ++y) {
-                        int ni = i + x;
-                        int nj = j + y;
-                        if (ni >= 0 && ni < ROWS && nj >= 0 && nj < COLS && board[ni][nj] == -1) {
-                            count++;
-                        }
-                    }
-                }
-                board[i][j] = count;
-            }
-        }
+    ROWS = layout.rows;
+    COLS = layout.cols;
+    MINES = layout.mines;
+    minePositions = layout.positions();
+    boardSeed = layout.seed;
+    boardLoaded = true;
+    loadedFilename = filename;
+    if (layout.hasSnapshot) {
+        loadedSnapshot = std::move(layout); // 对局快照，开局后恢复进度
     }
-
-    infile.close();
     return true;
 }
 
-// 初始化棋盘
-void initBoard(int ROWS, int COLS, int MINES) {
-    minePositions.clear();
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<> distribRow(0, ROWS - 1);
-    uniform_int_distribution<> distribCol(0, COLS - 1);
-
-    for (int i = 0; i < MINES; ++i) {
-        while (true) {
-            int row = distribRow(gen);
-            int col = distribCol(gen);
-            if (board[row][col] != -1) {
-                board[row][col] = -1;
-                minePositions.push_back({row, col});
-                break;
-            }
-        }
+// 保存进行中的对局（布局、格子状态、光标、用时），返回文件名，失败时返回空串
+string saveGameToFile(int cursorRow, int cursorCol, bool firstMove, long long elapsedMs) {
+    // 避开第一次揭示的布局只凭种子不能重新生成，不记录种子
+    BoardLayout layout = layoutFromPositions(game.rows(), game.cols(), game.minePositions(), game.safeRow() >= 0 ? 0 : boardSeed);
+    SnapshotInfo info;
+    info.cursorRow = cursorRow;
+    info.cursorCol = cursorCol;
+    info.elapsedMs = (uint64_t)elapsedMs;
+    info.firstMove = firstMove;
+    string filename = timestampName() + ".sl";
+    string error;
+    if (!saveGameSnapshot(filename, layout, game.board(), info, error, smallestEncoding(layout))) {
+        cerr << error << endl;
+        return "";
     }
+    return filename;
+}
 
-    for (int i = 0; i < ROWS; ++i) {
-        for (int j = 0; j < COLS; ++j) {
-            if (board[i][j] != -1) {
-                int count = 0;
-                for (int x = -1; x <= 1; ++x) {
-                    for (int y = -1; y <= 1; ++y) {
-                        int ni = i + x;
-                        int nj = j + y;
-                        if (ni >= 0 && ni < ROWS && nj >= 0 && nj < COLS && board[ni][nj] == -1) {
-                            count++;
-                        }
-                    }
-                }
-                board[i][j] = count;
-            }
-        }
+// 恢复快照中的对局进度，startTime 回拨已用时间
+bool resumeGame(int& cursorRow, int& cursorCol, bool& firstMove, chrono::high_resolution_clock::time_point& startTime, EventLog& eventLog) {
+    BoardLayout& s = loadedSnapshot;
+    bool ok = game.restoreStatus(s.statusPlanes, s.statusWords);
+    if (ok) {
+        cursorRow = s.snapshot.cursorRow;
+        cursorCol = s.snapshot.cursorCol;
+        firstMove = s.snapshot.firstMove;
+        startTime -= chrono::milliseconds(s.snapshot.elapsedMs);
+        eventLog.resume(loadedFilename, s.snapshot.elapsedMs);
     }
+    loadedSnapshot = BoardLayout();
+    return ok;
 }
 
+// 初始化棋盘：布局完全由种子决定，同一种子在任何机器上都生成同一布局
+void initBoard(int ROWS, int COLS, int MINES, uint64_t seed) {
+    boardSeed = seed;
+    minePositions = bitmapToPositions(generateMines(ROWS * COLS, MINES, seed), COLS);
+}
 
-void printBoard(bool showMines, double elapsedTime, int cursorRow, int cursorCol, int ROWS/*列*/, int COLS/*行*/) {
-    system("cls"); // 清屏
-    cout << COLOR_TIME << "用时：" << fixed << setprecision(2) << elapsedTime << " 秒" << COLOR_RESET << endl;
 
-    // 计算最大列号的宽度（位数）
-    int colWidth = to_string(COLS - 1).length() + 1;
+// 绘制棋盘：只输出与上一帧不同的格子，整帧一次写出
+void printBoard(bool showMines, double elapsedTime, int cursorRow, int cursorCol) {
+    renderer.draw(game.board(), showMines, elapsedTime, cursorRow, cursorCol);
+}
 
-    // 输出列号
-    cout << "   "; // 三个空格用于对齐行号
-    for (int j = 0; j < COLS; ++j) {
-        cout << setw(colWidth) << j;
-    }
-    cout << endl;
 
-    // 输出上边框
-    cout << " +";
-    cout << setfill('-') << setw(colWidth * COLS) << "+" << setfill(' ') << endl; // 一次性输出整个上边框
+// 处理一个按键（调用前已确认有按键可读）。局面或光标发生变化时 changed 置为 true，由 gameLoop 统一重绘
+// 每个按键先记入事件日志再执行，回放时按同样的顺序重新执行
+int handleInput(bool& firstMove, int& cursorRow, int& cursorCol, EventLog& eventLog, int ROWS, int COLS, bool& changed) {
+    int ch = readKey(); // 方向键已由 terminal.h 解码
 
-    for (int i = 0; i < ROWS; ++i) {
-        cout << setw(2) << i << "|"; // 输出行号和左边框
-        for (int j = 0; j < COLS; ++j) {
-            if (i == cursorRow && j == cursorCol) {
-                cout << "["; // 光标左括号
-            } else {
-                cout << " ";
+    switch (ch) {
+        case KEY_UP:
+            cursorRow = (cursorRow - 1 + ROWS) % ROWS;
+            eventLog.move(EV_MOVE_UP);
+            changed = true;
+            break;
+        case KEY_DOWN:
+            cursorRow = (cursorRow + 1) % ROWS;
+            eventLog.move(EV_MOVE_DOWN);
+            changed = true;
+            break;
+        case KEY_LEFT:
+            cursorCol = (cursorCol - 1 + COLS) % COLS;
+            eventLog.move(EV_MOVE_LEFT);
+            changed = true;
+            break;
+        case KEY_RIGHT:
+            cursorCol = (cursorCol + 1) % COLS;
+            eventLog.move(EV_MOVE_RIGHT);
+            changed = true;
+            break;
+        case ' ': // 空格键，标记/取消标记
+            if (firstMove) {
+                firstMove = false;
             }
-
-            if (status[i][j] == REVEALED || showMines) {
-                if (board[i][j] == -1) {
-                    cout << COLOR_MINE << "*" << COLOR_RESET; // 显示雷
-                } else if (board[i][j] == 0) {
-                    cout << COLOR_REVEALED << " " << COLOR_RESET; // 显示空格
-                } else {
-                    cout << COLOR_REVEALED << board[i][j] << COLOR_RESET; // 显示数字
-                }
-            } else if (status[i][j] == FLAGGED) {
-                cout << COLOR_FLAGGED << "F" << COLOR_RESET; // 显示旗帜
-            } else {
-                cout << COLOR_HIDDEN << "." << COLOR_RESET; // 显示隐藏
+            eventLog.flag(cursorRow, cursorCol);
+            game.toggleFlag(cursorRow, cursorCol);
+            changed = true;
+            break;
+        case KEY_ENTER: { // 回车键，翻开
+            if (firstMove) {
+                firstMove = false;
             }
-
-            if (i == cursorRow && j == cursorCol) {
-                cout << "]"; // 光标右括号
-            } else {
-                cout << " ";
+            eventLog.reveal(cursorRow, cursorCol);
+            if (!game.reveal(cursorRow, cursorCol)) {
+                return 2; // 踩到雷，游戏结束
             }
+            changed = true;
+            break;
         }
-        cout << "|" << endl; // 输出右边框
-    }
-
-    // 输出下边框
-    cout << " +";
-    cout << setfill('-') << setw(colWidth * COLS) << "+" << setfill(' ') << endl; // 一次性输出整个下边框
-}
-
-
-// 揭示单元格
-bool revealCell(int row, int col, int ROWS, int COLS) {
-    if (row < 0 || row >= ROWS || col < 0 || col >= COLS || status[row][col] != HIDDEN) {
-        return true; // 无效的单元格或已揭示
-    }
-
-    status[row][col] = REVEALED;
-    if (board[row][col] == -1) {
-        return false; // 踩到雷
-    }
-
-    if (board[row][col] == 0) {
-        for (int x = -1; x <= 1; ++x) {
-            for (int y = -1; y <= 1; ++y) {
-                if (x == 0 && y == 0) continue;
-                revealCell(row + x, col + y, ROWS, COLS); // 递归揭示相邻单元格
+        case 'c': // 双击：揭示已满足的数字格周围所有未标记的格子，整批揭示完只重绘一次
+        case 'C':
+            eventLog.chord(cursorRow, cursorCol);
+            if (!game.chord(cursorRow, cursorCol)) {
+                return 2; // 旗插错，踩到雷
             }
-        }
+            changed = true;
+            break;
+        case 's': // 保存当前对局
+        case 'S':
+            return 3;
+        case 'h': // 提示：光标所在格是雷的概率和最安全的格子
+        case 'H':
+            eventLog.hint(cursorRow, cursorCol);
+            return 4;
+        case KEY_ESC: // Esc 键，退出
+            cout << "退出游戏。" << endl;
+            eventLog.quit(boardHash(game.board()));
+            eventLog.flush();
+            return 1; // 返回 1 表示退出
+        default:
+            if (ch >= KEY_EXTENDED) {
+                eventLog.unknownKey(ch - KEY_EXTENDED);
+            } else {
+                eventLog.invalidKey(ch);
+            }
+            break;
     }
-    return true; // 成功揭示
+    return 0; // 游戏继续
 }
 
-// 切换标记状态
-void toggleFlag(int row, int col, int ROWS, int COLS) {
-    if (row < 0 || row >= ROWS || col < 0 || col >= COLS || status[row][col] == REVEALED) {
-        return; // 无效的单元格或已揭示
+// 按当前看得到的局面计算每格是雷的概率（见 analyzer.h），显示光标所在格和最安全的格子
+void showHint(int cursorRow, int cursorCol) {
+    if (game.pending()) {
+        cout << "提示：第一次揭示总是安全的。" << endl;
+        return;
     }
-
-    if (status[row][col] == FLAGGED) {
-        status[row][col] = HIDDEN;
-    } else {
-        status[row][col] = FLAGGED;
+    static ProbabilityAnalyzer analyzer;
+    vector<double> probability;
+    if (!analyzer.analyze(game.board(), probability)) {
+        cout << "提示：局面矛盾，请检查插的旗。" << endl;
+        return;
     }
-}
-
-// 检查是否获胜
-bool checkWin(int ROWS, int COLS) {
-    for (int i = 0; i < ROWS; ++i) {
-        for (int j = 0; j < COLS; ++j) {
-            if (board[i][j] != -1 && status[i][j] != REVEALED) {
-                return false; // 还有未揭示的非雷单元格
+    const Board& board = game.board();
+    int bestRow = -1, bestCol = -1;
+    double best = 2;
+    for (int i = 0; i < board.rows(); ++i) {
+        for (int j = 0; j < board.cols(); ++j) {
+            double p = probability[board.index(i, j)];
+            if (p >= 0 && p < best) {
+                best = p;
+                bestRow = i;
+                bestCol = j;
             }
         }
     }
-    return true; // 所有非雷单元格都已揭示
+    if (bestRow < 0) return;
+    cout << "提示：";
+    double here = probability[board.index(cursorRow, cursorCol)];
+    if (here >= 0) {
+        cout << "此格是雷的概率 " << fixed << setprecision(1) << here * 100 << "%，";
+    }
+    cout << "最安全的格子 " << bestRow << " " << bestCol << "（" << fixed << setprecision(1) << best * 100 << "%）" << endl;
 }
 
+// 输入到画面完成输出的延迟统计
+struct LatencyStats {
+    long long frames = 0;
+    double totalUs = 0;
+    double maxUs = 0;
 
-
-
-int handleInput(bool& firstMove, int& cursorRow, int& cursorCol, ofstream& logFile, const chrono::high_resolution_clock::time_point& startTime, int ROWS, int COLS, double& elapsedTime) {
-    if (_kbhit()) {
-        int ch = _getch();
-        logFile << "Input: ";
-
-        if (ch == 0xE0) { // 扩展按键（方向键）
-            ch = _getch();
-            switch (ch) {
-                case 72: // Up
-                    cursorRow = (cursorRow - 1 + ROWS) % ROWS;
-                    logFile << "Up" << endl;
-                    printBoard(false, elapsedTime, cursorRow, cursorCol, ROWS, COLS);
-                    break;
-                case 80: // Down
-                    cursorRow = (cursorRow + 1) % ROWS;
-                    logFile << "Down" << endl;
-                    printBoard(false, elapsedTime, cursorRow, cursorCol, ROWS, COLS);
-                    break;
-                case 75: // Left
-                    cursorCol = (cursorCol - 1 + COLS) % COLS;
-                    logFile << "Left" << endl;
-                    printBoard(false, elapsedTime, cursorRow, cursorCol, ROWS, COLS);
-                    break;
-                case 77: // Right
-                    cursorCol = (cursorCol + 1) % COLS;
-                    logFile << "Right" << endl;
-                    printBoard(false, elapsedTime, cursorRow, cursorCol, ROWS, COLS);
-                    break;
-                default:
-                    logFile << "Unknown extended key: " << ch << endl;
-                    break;
-            }
-            return 0; // 防止在方向键操作后还执行其他操作
-        } else {
-            switch (ch) {
-                case ' ': // 空格键，标记/取消标记
-                    if (firstMove) {
-                        firstMove = false;
-                    }
-                    toggleFlag(cursorRow, cursorCol, ROWS, COLS);
-                    logFile << "Flag/Unflag at: " << cursorRow << " " << cursorCol << endl;
-                    printBoard(false, elapsedTime, cursorRow, cursorCol, ROWS, COLS);
-                    break;
-                case 13: { // 回车键，翻开
-                    if (firstMove) {
-                        firstMove = false;
-                    }
-                    if (!revealCell(cursorRow, cursorCol, ROWS, COLS)) {
-                        return 2; // 踩到雷，游戏结束
-                    }
-                    logFile << "Reveal at: " << cursorRow << " " << cursorCol << endl;
-                    printBoard(false, elapsedTime, cursorRow, cursorCol, ROWS, COLS);
-                    break;
-                }
-                case 27: // Esc 键，退出
-                    cout << "退出游戏。" << endl;
-                    logFile << "Game Ended by User." << endl;
-                    logFile.close();
-                    return 1; // 返回 1 表示退出
-                default:
-                    logFile << (char)ch << " is invalid." << endl;
-                    break;
-            }
-        }
+    void add(double us) {
+        frames++;
+        totalUs += us;
+        maxUs = max(maxUs, us);
     }
-    return 0; // 没有按键按下，游戏继续
-}
+    double averageUs() const { return frames ? totalUs / frames : 0; }
+};
 
 
 
 // 处理游戏结束
-bool gameOver(ofstream& logFile, double duration, bool win, bool& playAgain, bool& sameSeed, int ROWS, int COLS, int MINES) {
+bool gameOver(EventLog& eventLog, double duration, bool win, bool& playAgain, bool& sameSeed, const LatencyStats& latency) {
     if (win) {
         cout << COLOR_REVEALED << "恭喜你，获胜！" << COLOR_RESET << endl;
-        logFile << "Game Over (Won). Time: " << duration / 1000.0 << "s" << endl;
     } else {
         cout << COLOR_MINE << "你踩到雷了！游戏结束。" << COLOR_RESET << endl;
-        logFile << "Game Over (Lost). Time: " << duration / 1000.0 << "s" << endl;
-        _getch(); // 暂停，按任意键继续
+    }
+    eventLog.gameOver(win, (uint64_t)(duration * 1000 + 0.5), boardHash(game.board()));
+    if (!game.pending()) {
+        // 3BV/s 按已完成的 3BV 计算：揭开全部安全格时就是整个布局的 3BV，
+        // 踩雷或靠插对全部旗获胜时只算已揭开的部分
+        BoardMetrics m = game.metrics();
+        int solved = solvedBbbv(game.board());
+        cout << "布局：3BV " << m.bbbv << "（开局区域 " << m.openings << "，孤岛 " << m.islands << "），ZiNi " << m.zini;
+        if (solved < m.bbbv) cout << "，完成 3BV " << solved << "/" << m.bbbv;
+        if (duration > 0) cout << "，3BV/s " << fixed << setprecision(2) << solved / duration;
+        cout << endl;
+        eventLog.metrics(m, solved);
+    }
+    if (latency.frames > 0) {
+        cout << "输入响应：平均 " << fixed << setprecision(1) << latency.averageUs() << " 微秒，最大 " << latency.maxUs << " 微秒（" << latency.frames << " 帧）" << endl;
+        eventLog.latency(latency.averageUs(), latency.maxUs, latency.frames);
+    }
+    if (boardSeed != 0 && game.safeRow() >= 0) {
+        cout << "种子：" << seedText(boardSeed) << "（" << ROWS << "x" << COLS << "，" << MINES << " 雷，第一次揭示 "
+             << game.safeRow() << " " << game.safeCol() << (game.noGuess() ? "，无猜" : "") << "）" << endl;
+    } else if (boardSeed != 0) {
+        cout << "种子：" << seedText(boardSeed) << "（" << ROWS << "x" << COLS << "，" << MINES << " 雷）" << endl;
+    }
+    if (renderer.frames() > 0) {
+        eventLog.render(renderer.frames(), renderer.totalBytes() / renderer.frames());
+    }
+    if (!win) {
+        RawMode raw;
+        readKey(); // 暂停，按任意键继续
     }
 
 
-    logFile.close();
+    eventLog.flush(); // 一局的事件在这里一次写出
 
     cout << "游戏结束！再来一局？(y/n/s - 相同种子,l - 加载游戏): ";
-    char playAgainChoice;
+    char playAgainChoice = 'n'; // 输入结束时读不到选择，按不再来一局处理
     cin >> playAgainChoice;
 
     if (playAgainChoice == 'l' || playAgainChoice == 'L') {
@@ -388,23 +336,56 @@ bool gameOver(ofstream& logFile, double duration, bool win, bool& playAgain, boo
         }
         return false; // 不需要重新初始化棋盘，但需要重新开始游戏循环(相同种子)
     }
+    sameSeed = false; // 新的一局使用新的种子
     return false; // 用户选择重新开始新游戏，不需要重新初始化棋盘
 }
 
 
 
 
+// 读取一个值。输入结束或格式不对时返回 false；不是输入结束时丢弃这一行，之后的读取照常进行
+template <class T>
+bool readValue(T& value) {
+    if (cin >> value) return true;
+    if (!cin.eof()) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+    return false;
+}
+
+// 读取行列数，超出 validBoardSize 的范围时重新输入。读取失败返回 false
+bool promptBoardSize(int& rows, int& cols) {
+    while (true) {
+        cout << "请输入棋盘行数（ROWS）：";
+        if (!readValue(rows)) return false;
+        cout << "请输入棋盘列数（COLS）：";
+        if (!readValue(cols)) return false;
+        if (validBoardSize(rows, cols, 0)) return true;
+        cout << "行列数不合法，请重新输入（1 到 " << SL_MAX_SIDE << " 之间）。" << endl;
+    }
+}
+
+void useDefaultDifficulty(int& ROWS, int& COLS, int& MINES) {
+    cout << "无效的选择，使用默认设置 (10x10, 15 雷)。" << endl;
+    ROWS = 10;
+    COLS = 10;
+    MINES = 15;
+}
+
 void chooseDifficulty(int& ROWS, int& COLS, int& MINES, bool& sameSeed) {
-    if (sameSeed) return;
+    if (sameSeed || boardLoaded) return;
 
-    int choice;
+    int choice = 0; // 读取失败时按无效选择处理
     cout << "请选择游戏难度：" << endl;
     cout << "1. 初级 (10x10, 15 雷)" << endl;
     cout << "2. 中级 (15x15, 25 雷)" << endl;
     cout << "3. 高级 (20x20, 35 雷)" << endl;
     cout << "4. 自定义" << endl;
     cout << "5. 加载文件" << endl;
-    cin >> choice;
+    cout << "6. 输入种子" << endl;
+    cout << "7. 无猜模式（当前：" << (noGuessMode ? "开" : "关") << "）" << endl;
+    readValue(choice);
 
     switch (choice) {
         case 1:
@@ -423,13 +404,16 @@ void chooseDifficulty(int& ROWS, int& COLS, int& MINES, bool& sameSeed) {
             MINES = 35;
             break;
         case 4: {
-            cout << "请输入棋盘行数（ROWS）：";
-            cin >> ROWS;
-            cout << "请输入棋盘列数（COLS）：";
-            cin >> COLS;
+            if (!promptBoardSize(ROWS, COLS)) {
+                useDefaultDifficulty(ROWS, COLS, MINES);
+                break;
+            }
             do {
                 cout << "请输入雷数（MINES）：";
-                cin >> MINES;
+                if (!readValue(MINES)) {
+                    useDefaultDifficulty(ROWS, COLS, MINES);
+                    break;
+                }
                 if (MINES < ROWS * COLS * 0.15 || MINES > ROWS * COLS * 0.85) {
                     cout << "雷数不合法，请重新输入（雷数应在棋盘面积的15%到85%之间）。" << endl;
                 }
@@ -451,98 +435,144 @@ void chooseDifficulty(int& ROWS, int& COLS, int& MINES, bool& sameSeed) {
             }
             break;
         }
+        case 6: {
+            // 种子只有配合相同的行列数和雷数才能生成同一布局；任何一项读取失败都改用默认设置
+            int rows, cols, mines = 0;
+            bool ok = promptBoardSize(rows, cols);
+            while (ok && (mines <= 0 || !validBoardSize(rows, cols, mines))) {
+                cout << "请输入雷数（MINES）：";
+                ok = readValue(mines);
+            }
+            string text;
+            uint64_t seed = 0;
+            while (ok && seed == 0) {
+                cout << "请输入种子（16 位十六进制）：";
+                ok = readValue(text);
+                if (!ok) break;
+                char* end = nullptr;
+                errno = 0;
+                seed = strtoull(text.c_str(), &end, 16);
+                if (*end != '\0' || errno == ERANGE || text[0] == '-' || text[0] == '+') {
+                    seed = 0; // 整串都必须是十六进制数字，且不超过 64 位
+                }
+                if (seed == 0) cout << "种子不合法，请重新输入。" << endl;
+            }
+            if (!ok) {
+                useDefaultDifficulty(ROWS, COLS, MINES);
+                break;
+            }
+            ROWS = rows;
+            COLS = cols;
+            MINES = mines;
+            boardSeed = seed;
+            seedEntered = true;
+            break;
+        }
+        case 7:
+            // 从第一次揭示开始只靠推理就能完成，不需要猜；切换后重新选择难度
+            noGuessMode = !noGuessMode;
+            chooseDifficulty(ROWS, COLS, MINES, sameSeed);
+            break;
         default:
-            cout << "无效的选择，使用默认设置 (10x10, 15 雷)。" << endl;
+            useDefaultDifficulty(ROWS, COLS, MINES);
             break;
     }
 }
 
 
-bool checkWinByFlags(int ROWS, int COLS) {
-    int flaggedCount = 0;
-    for (int i = 0; i < ROWS; ++i) {
-        for (int j = 0; j < COLS; ++j) {
-            if (status[i][j] == FLAGGED && board[i][j] == -1) {
-                flaggedCount++;
-            }
-        }
-    }
-    return flaggedCount == MINES;
-}
-
-int gameLoop(bool& firstMove, int& cursorRow, int& cursorCol, ofstream& logFile, const chrono::high_resolution_clock::time_point& startTime, bool& playAgain, bool& sameSeed, int ROWS, int COLS, int MINES) {
+int gameLoop(bool& firstMove, int& cursorRow, int& cursorCol, EventLog& eventLog, const chrono::high_resolution_clock::time_point& startTime, bool& playAgain, bool& sameSeed, int ROWS, int COLS) {
     double elapsedTime = 0;
+    long long shownSecond = 0; // 画面上当前显示的整秒数
+    LatencyStats latency;
+    RawMode raw; // 游戏进行中逐键读取；结束画面需要 cin 输入，先恢复
     while (true) {
+        // 第一步之前计时器不走，一直阻塞等待按键；之后最多等到下一个整秒刷新计时器
+        int timeoutMs = -1;
         if (!firstMove) {
-            auto currentTime = chrono::high_resolution_clock::now();
-            elapsedTime = chrono::duration_cast<std::chrono::milliseconds>(currentTime - startTime).count() / 1000.0;
+            auto elapsedMs = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - startTime).count();
+            timeoutMs = (int)(1000 - elapsedMs % 1000);
         }
-        int result = handleInput(firstMove, cursorRow, cursorCol, logFile, startTime, ROWS, COLS, elapsedTime);
-        if (result == 1) {
-            return 1; // 用户选择退出游戏
+        bool changed = false;
+        bool hasKey = waitForKey(timeoutMs);
+        auto inputTime = chrono::high_resolution_clock::now();
+        if (!hasKey) {
+            eventLog.flush(); // 计时器空闲唤醒时顺便写出日志，按键处理过程中没有文件操作
         }
-        if (result == 2) { // 踩到雷！
-            auto endTime = chrono::high_resolution_clock::now();
-            elapsedTime = chrono::duration_cast<chrono::milliseconds>(endTime - startTime).count() / 1000.0;
-            printBoard(true, elapsedTime, cursorRow, cursorCol, ROWS, COLS);
-            if (gameOver(logFile, elapsedTime, false, playAgain, sameSeed, ROWS, COLS, MINES)) {
+        if (hasKey) {
+            int result = handleInput(firstMove, cursorRow, cursorCol, eventLog, ROWS, COLS, changed);
+            if (result == 1) {
+                return 1; // 用户选择退出游戏
+            }
+            if (result == 3 && game.pending() && game.noGuess()) {
+                // 无猜布局要等第一次揭示才能确定，现在保存只能存普通布局，会失去无猜保证
+                cout << "无猜模式下要先揭示一个格子才能保存。" << endl;
+            } else if (result == 3) {
+                game.generateNow(); // 还没揭示过就保存时，布局按种子确定下来，与存档一致
+                long long elapsedMs = firstMove ? 0 : chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - startTime).count();
+                string filename = saveGameToFile(cursorRow, cursorCol, firstMove, elapsedMs);
+                if (!filename.empty()) {
+                    cout << "游戏已保存到 " << filename << endl;
+                }
+                eventLog.save(filename);
+            }
+            if (result == 4) {
+                showHint(cursorRow, cursorCol);
+            }
+            if (result == 2) { // 踩到雷！
+                auto endTime = chrono::high_resolution_clock::now();
+                elapsedTime = chrono::duration_cast<chrono::milliseconds>(endTime - startTime).count() / 1000.0;
+                printBoard(true, elapsedTime, cursorRow, cursorCol);
+                raw.restore();
+                gameOver(eventLog, elapsedTime, false, playAgain, sameSeed, latency);
                 return 0;
             }
+        }
+
+        if (game.state() == WON) { // 揭示完所有安全格或正确标记所有雷
+            auto endTime = std::chrono::high_resolution_clock::now();
+            elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count() / 1000.0;
+            printBoard(true, elapsedTime, cursorRow, cursorCol);
+            raw.restore();
+            gameOver(eventLog, elapsedTime, true, playAgain, sameSeed, latency);
             return 0;
         }
 
+        // 只在局面变化或计时器跨过整秒时重绘
         if (!firstMove) {
-            printBoard(false, elapsedTime, cursorRow, cursorCol, ROWS, COLS);
+            elapsedTime = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now() - startTime).count() / 1000.0;
         }
-
-        if (checkWin(ROWS, COLS) || checkWinByFlags(ROWS, COLS)) { // 同时检查两种获胜条件
-            auto endTime = std::chrono::high_resolution_clock::now();
-            elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count() / 1000.0;
-            printBoard(true, elapsedTime, cursorRow, cursorCol, ROWS, COLS);
-            if (gameOver(logFile, elapsedTime, true, playAgain, sameSeed, ROWS, COLS, MINES)) {
-                return 0;
+        if (changed || (long long)elapsedTime != shownSecond) {
+            shownSecond = (long long)elapsedTime;
+            printBoard(false, (double)shownSecond, cursorRow, cursorCol);
+            if (changed) {
+                latency.add(chrono::duration<double, micro>(chrono::high_resolution_clock::now() - inputTime).count());
             }
-            return 0;
         }
-        this_thread::sleep_for(chrono::milliseconds(100)); // 适当的延时
     }
 }
 
-// 新增的 rebuildBoard 函数
+// 新增的 rebuildBoard 函数：按雷的位置开始新的一局
 void rebuildBoard(int ROWS, int COLS, const std::vector<std::pair<int, int>>& minePositions) {
-    board.assign(ROWS, std::vector<int>(COLS, 0)); // 清空 board
-    for (const auto& pos : minePositions) {
-        board[pos.first][pos.second] = -1; // 设置雷
-    }
-    for (int i = 0; i < ROWS; ++i) {
-        for (int j = 0; j < COLS; ++j) {
-            if (board[i][j] != -1) {
-                int count = 0;
-                for (int x = -1; x <= 1; ++x) {
-                    for (int y = -1; y <= 1; ++y) {
-                        int ni = i + x;
-                        int nj = j + y;
-                        if (ni >= 0 && ni < ROWS && nj >= 0 && nj < COLS && board[ni][nj] == -1) {
-                            count++;
-                        }
-                    }
-                }
-                board[i][j] = count;
-            }
-        }
-    }
+    game.create(ROWS, COLS, minePositions);
 }
 
 
 
 int main() {
-    enableVirtualTerminalProcessing();
+    terminalInit();
     srand(time(0));
 
     ROWS = 10;
     COLS = 10;
     MINES = 15;
 
+    // 二进制事件日志，整个程序运行期间只打开一次；用 logtool 可转换为文本
+    EventLog eventLog;
+    if (!eventLog.open("minesweeper_log.bin")) {
+        cerr << "无法打开日志文件！" << endl;
+        return 1;
+    }
+
     bool playAgain = true;
     bool sameSeed = false;
     double elapsedTime = 0;
@@ -550,12 +580,7 @@ int main() {
     while (playAgain) {
         chooseDifficulty(ROWS, COLS, MINES, sameSeed);
 
-        ofstream logFile("minesweeper_log.txt", ios::app);
-        if (!logFile.is_open()) {
-            cerr << "无法打开日志文件！" << endl;
-            return 1;
-        }
-        logFile << "New Game Started at: " << std::time(0) << std::endl;
+        time_t gameStartTime = time(0);
 
         int cursorRow = 0;
         int cursorCol = 0;
@@ -563,39 +588,69 @@ int main() {
         elapsedTime = 0;
 
         cout << "按任意键开始游戏..." << endl;
-        _getch();
-
-        board.assign(ROWS, vector<int>(COLS, 0));
-        status.assign(ROWS, vector<CellStatus>(COLS, HIDDEN));
-
-        if (!sameSeed) {
-            minePositions.clear();
-            initBoard(ROWS, COLS, MINES);
-
-            cout << "是否保存当前设置？(y/n): ";
-            char saveChoice;
-            cin >> saveChoice;
-            if (saveChoice == 'y' || saveChoice == 'Y') {
-                time_t rawtime;
-                struct tm* timeinfo;
-                char buffer[80];
-
-                time(&rawtime);
-                timeinfo = localtime(&rawtime);
+        {
+            RawMode raw;
+            readKey();
+        }
 
-                strftime(buffer, sizeof(buffer), "%Y%m%d%H%M%S", timeinfo);
-                string str(buffer);
 
-                if (!saveBoardToFile(str, ROWS, COLS, MINES, minePositions)) {
-                    cerr << "保存文件失败" << endl;
+        bool deferred = false; // 布局在第一次揭示时生成，第一次揭示不会踩雷
+        if (boardLoaded) {
+            boardLoaded = false; // 使用从文件加载的布局
+        } else if (sameSeed && game.safeRow() >= 0) {
+            // 上一局的布局避开了第一次揭示的格子，只凭种子不能重新生成，直接复用
+            minePositions = game.minePositions();
+            boardSeed = 0;
+        } else if (sameSeed && boardSeed != 0 && !game.pending()) {
+            initBoard(ROWS, COLS, MINES, boardSeed); // 相同种子重新生成出同一布局
+        } else if (!sameSeed || boardSeed != 0) { // 没有种子的布局只能直接复用
+            if (!sameSeed && !seedEntered) {
+                boardSeed = randomSeed();
+            }
+            seedEntered = false;
+            deferred = true;
+
+            if (!sameSeed && !noGuessMode) { // 无猜布局要等第一次揭示才能确定，开局前不能保存
+                cout << "是否保存当前设置？(y/n): ";
+                char saveChoice;
+                cin >> saveChoice;
+                if (saveChoice == 'y' || saveChoice == 'Y') {
+                    // 保存的文件要与这一局一致，布局现在就按种子生成，不再延迟
+                    initBoard(ROWS, COLS, MINES, boardSeed);
+                    deferred = false;
+                    if (!saveBoardToFile(timestampName(), ROWS, COLS, minePositions)) {
+                        cerr << "保存文件失败" << endl;
+                    }
                 }
             }
         }
 
-        rebuildBoard(ROWS, COLS, minePositions);
+        if (deferred) {
+            game.createDeferred(ROWS, COLS, MINES, boardSeed, noGuessMode);
+        } else {
+            rebuildBoard(ROWS, COLS, minePositions);
+        }
+        eventLog.gameStart((uint64_t)gameStartTime, ROWS, COLS, MINES, boardSeed);
+        if (deferred) {
+            eventLog.deferredLayout(noGuessMode);
+        }
+        if (boardSeed == 0) { // 没有种子的布局（从旧文件加载）直接记入日志，回放时才能还原
+            eventLog.layout(layoutFromPositions(ROWS, COLS, minePositions).bits, ROWS, COLS, MINES);
+        }
+        auto startTime = chrono::high_resolution_clock::now();
+        if (loadedSnapshot.hasSnapshot) {
+            if (resumeGame(cursorRow, cursorCol, firstMove, startTime, eventLog)) {
+                elapsedTime = (double)(chrono::duration_cast<chrono::seconds>(chrono::high_resolution_clock::now() - startTime).count());
+            } else {
+                cout << "存档中的对局状态无效，从头开始。" << endl;
+                rebuildBoard(ROWS, COLS, minePositions);
+            }
+        }
+        renderer.invalidate(); // 新的一局整屏重绘
+        renderer.resetStats();
 
-        printBoard(false, elapsedTime, cursorRow, cursorCol, ROWS, COLS);
-        int gameResult = gameLoop(firstMove, cursorRow, cursorCol, logFile, chrono::high_resolution_clock::now(), playAgain, sameSeed, ROWS, COLS, MINES);
+        printBoard(false, elapsedTime, cursorRow, cursorCol);
+        int gameResult = gameLoop(firstMove, cursorRow, cursorCol, eventLog, startTime, playAgain, sameSeed, ROWS, COLS);
         if (gameResult == 1) {
             playAgain = false;
             break;
@@ -610,7 +665,6 @@ int main() {
         } else {
             sameSeed = false;
         }
-        logFile.close();
     }
     return 0;
 }
\ No newline at end of file
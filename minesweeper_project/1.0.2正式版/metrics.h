@@ -0,0 +1,179 @@
+#pragma once
+
+// 布局难度指标，只取决于布局，与格子的揭开 / 插旗状态无关（Game::metrics 在需要时计算）：
+//   开局区域（openings）：八方向相连的 0 格组成的区域，点其中任一格就整片展开（连同周围的数字）
+//   3BV：不插旗时揭开全部安全格最少要点的次数 = 开局区域数 + 不挨着任何 0 格的数字格数
+//   孤岛（islands）：这些必须单独点开的数字格按八方向相连组成的块数
+//   ZiNi：允许插旗和双击时点击次数的估计，通常小于 3BV
+// 先逐行无分支地给格子分类（是否挨着 0 格用与 adjacency.h 相同的可分离方法：先求水平相邻三格，再合并上中下三行），
+// 开局区域、3BV 和孤岛在接下来的一遍按行扫描中算出：每个格子只和已扫描过的邻居合并（并查集），
+// 扫描结束时集合数就是区域数。ZiNi 在分类结果上再做一遍贪心（精确的最少点击数需要搜索，这里只要估计）。
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "board.h"
+
+struct BoardMetrics {
+    int bbbv = 0;
+    int openings = 0;
+    int islands = 0;
+    int zini = 0;
+};
+
+// metricsClassify 给每个格子的分类
+enum MetricsKind : uint8_t {
+    METRICS_OTHER = 0,    // 雷、边框、挨着 0 格的数字格（开局区域展开时顺带揭开）或不参与统计的格子
+    METRICS_OPENING = 1,  // 0 格
+    METRICS_ISOLATED = 2, // 不挨着 0 格、必须单独点开的数字格
+};
+
+inline int metricsFind(std::vector<int>& parent, int x) {
+    while (parent[x] != x) x = parent[x] = parent[parent[x]];
+    return x;
+}
+
+// out[c] = 第 c-1、c、c+1 格中有 0 格，处理第 1..cols 列
+inline void metricsZeroRow(const uint8_t* row, uint8_t* out, int cols) {
+    const uint8_t ZERO_MASK = Board::BORDER_BIT | Board::MINE_BIT | Board::COUNT_MASK;
+    for (int c = 1; c <= cols; ++c) {
+        out[c] = (uint8_t)(((row[c - 1] & ZERO_MASK) == 0) | ((row[c] & ZERO_MASK) == 0) | ((row[c + 1] & ZERO_MASK) == 0));
+    }
+}
+
+// 给每个格子分类写入 kind。revealedOnly 时只有已揭开的格子参与统计（已揭开的 0 格所在区域一定整片揭开了）
+inline void metricsClassify(const Board& board, bool revealedOnly, std::vector<uint8_t>& kind) {
+    const uint8_t* cells = board.data();
+    int rows = board.rows(), cols = board.cols(), stride = board.stride();
+    kind.assign((size_t)(rows + 2) * stride, METRICS_OTHER);
+    // 上、中、下三行的水平结果轮换使用；第一行之上和最后一行之下是边框，没有 0 格
+    std::vector<uint8_t> near(3 * (size_t)stride, 0);
+    uint8_t* above = &near[0];
+    uint8_t* middle = &near[stride];
+    uint8_t* below = &near[2 * (size_t)stride];
+    const uint8_t statusMask = revealedOnly ? Board::STATUS_MASK : 0;
+    const uint8_t status = revealedOnly ? Board::REVEALED_BITS : 0;
+    metricsZeroRow(cells + board.index(0, -1), middle, cols);
+    for (int i = 0; i < rows; ++i) {
+        const uint8_t* row = cells + board.index(i, -1);
+        if (i + 1 < rows) {
+            metricsZeroRow(row + stride, below, cols);
+        } else {
+            std::fill(below, below + stride, 0);
+        }
+        uint8_t* out = &kind[board.index(i, -1)];
+        for (int c = 1; c <= cols; ++c) {
+            uint8_t x = row[c];
+            uint8_t counted = (x & (Board::BORDER_BIT | Board::MINE_BIT)) == 0 && (x & statusMask) == status;
+            uint8_t zero = (x & Board::COUNT_MASK) == 0;
+            uint8_t alone = (above[c] | middle[c] | below[c]) ^ 1;
+            out[c] = (uint8_t)(counted * (zero | (alone << 1))); // 0 格为 1，单独数字格为 2
+        }
+        uint8_t* t = above;
+        above = middle;
+        middle = below;
+        below = t;
+    }
+}
+
+// 按行扫描 metricsClassify 的结果：openings 为 0 格区域数，isolated 为单独数字格数，islands 为它们组成的块数。
+// 已扫描过的邻居是左、左上、上、右上：上方同类时左、左上、右上都已和它合并，只需合并上方；
+// 否则左和左上互相相邻，取其一，再加右上，每格最多合并两次
+inline void metricsScan(const Board& board, const std::vector<uint8_t>& kind, int& openings, int& isolated, int& islands) {
+    int stride = board.stride();
+    std::vector<int> parent(kind.size());
+    int sets[3] = {0, 0, 0};
+    isolated = 0;
+    for (int i = 0; i < board.rows(); ++i) {
+        int first = board.index(i, 0);
+        for (int idx = first; idx < first + board.cols(); ++idx) {
+            uint8_t k = kind[idx];
+            if (k == METRICS_OTHER) continue;
+            isolated += k == METRICS_ISOLATED;
+            int root = -1;
+            if (kind[idx - stride] == k) {
+                root = metricsFind(parent, idx - stride);
+            } else {
+                if (kind[idx - 1] == k) {
+                    root = metricsFind(parent, idx - 1);
+                } else if (kind[idx - stride - 1] == k) {
+                    root = metricsFind(parent, idx - stride - 1);
+                }
+                if (kind[idx - stride + 1] == k) {
+                    int r = metricsFind(parent, idx - stride + 1);
+                    if (root < 0) {
+                        root = r;
+                    } else if (r != root) {
+                        parent[r] = root;
+                        sets[k]--;
+                    }
+                }
+            }
+            if (root < 0) {
+                root = idx;
+                sets[k]++;
+            }
+            parent[idx] = root;
+        }
+    }
+    openings = sets[METRICS_OPENING];
+    islands = sets[METRICS_ISOLATED];
+}
+
+// ZiNi 的贪心估计：先点开所有开局区域（此后没有未揭开的 0 格，揭开任何格子都不会再连锁展开，
+// 未揭开的安全格正好是单独数字格）；再按行扫描数字格，双击划算时（周围能揭开的格子数多于
+// 需要补插的旗数 + 1 次双击）就点开它、插旗并双击；最后剩下的安全格各点一次
+inline int ziniEstimate(const Board& board, std::vector<uint8_t>& kind, int openings, int isolated) {
+    const uint8_t OPENED = 3, FLAGGED = 4;
+    const uint8_t* cells = board.data();
+    const int* nb = board.neighbours();
+    int clicks = openings, hiddenLeft = isolated;
+    for (int i = 0; i < board.rows(); ++i) {
+        for (int j = 0; j < board.cols(); ++j) {
+            int idx = board.index(i, j);
+            if ((cells[idx] & (Board::BORDER_BIT | Board::MINE_BIT)) || (cells[idx] & Board::COUNT_MASK) == 0) continue;
+            int hidden = 0, flagsNeeded = 0;
+            for (int k = 0; k < 8; ++k) {
+                int n = idx + nb[k];
+                hidden += kind[n] == METRICS_ISOLATED;
+                flagsNeeded += (cells[n] & Board::MINE_BIT) && kind[n] != FLAGGED;
+            }
+            if (hidden <= flagsNeeded + 1) continue; // 逐个点开不比插旗再双击更费
+            bool closed = kind[idx] == METRICS_ISOLATED;
+            clicks += flagsNeeded + 1 + closed;
+            hiddenLeft -= hidden + closed;
+            kind[idx] = OPENED;
+            for (int k = 0; k < 8; ++k) {
+                int n = idx + nb[k];
+                if (cells[n] & Board::MINE_BIT) {
+                    kind[n] = FLAGGED;
+                } else if (kind[n] == METRICS_ISOLATED) {
+                    kind[n] = OPENED;
+                }
+            }
+        }
+    }
+    return clicks + hiddenLeft;
+}
+
+// 计算布局的全部指标（与格子的揭开 / 插旗状态无关）
+inline BoardMetrics computeBoardMetrics(const Board& board) {
+    BoardMetrics m;
+    std::vector<uint8_t> kind;
+    int isolated;
+    metricsClassify(board, false, kind);
+    metricsScan(board, kind, m.openings, isolated, m.islands);
+    m.bbbv = m.openings + isolated;
+    m.zini = ziniEstimate(board, kind, m.openings, isolated);
+    return m;
+}
+
+// 已完成的 3BV：已揭开的开局区域数 + 已揭开的单独数字格数。揭开全部安全格时等于 3BV，用来计算 3BV/s
+inline int solvedBbbv(const Board& board) {
+    std::vector<uint8_t> kind;
+    int openings, isolated, islands;
+    metricsClassify(board, true, kind);
+    metricsScan(board, kind, openings, isolated, islands);
+    return openings + isolated;
+}
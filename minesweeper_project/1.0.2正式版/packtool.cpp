@@ -0,0 +1,156 @@
+// 布局包工具
+//
+//   packtool generate 输出文件 数量 行数 列数 雷数 [--seed 十六进制主种子] [--noguess] [--threads 线程数]
+//                                     用全部 CPU 生成布局包（格式见 boardpack.h）
+//   packtool info 布局包               显示文件头，解码全部布局并核对雷数
+//   packtool extract 布局包 序号 输出.sl 取出一个布局保存为 .sl 文件，可在游戏中“加载文件”；
+//                                     无猜布局保存为已揭示第一次揭示格的对局快照，加载后从这一步继续
+//
+// 编译：g++ -O2 -std=c++17 -pthread packtool.cpp -o packtool
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "boardfile.h"
+#include "boardpack.h"
+#include "game.h"
+
+using namespace std;
+
+static int usage() {
+    cerr << "用法：packtool generate 输出文件 数量 行数 列数 雷数 [--seed 十六进制主种子] [--noguess] [--threads 线程数]" << endl;
+    cerr << "      packtool info 布局包" << endl;
+    cerr << "      packtool extract 布局包 序号 输出.sl" << endl;
+    return 2;
+}
+
+static int generate(int argc, char** argv) {
+    if (argc < 7) return usage();
+    PackOptions o;
+    string path = argv[2];
+    o.count = strtoull(argv[3], nullptr, 10);
+    o.rows = atoi(argv[4]);
+    o.cols = atoi(argv[5]);
+    o.mines = atoi(argv[6]);
+    o.masterSeed = randomSeed();
+    for (int i = 7; i < argc; ++i) {
+        if (!strcmp(argv[i], "--seed") && i + 1 < argc) {
+            o.masterSeed = strtoull(argv[++i], nullptr, 16);
+        } else if (!strcmp(argv[i], "--noguess")) {
+            o.noGuess = true;
+        } else if (!strcmp(argv[i], "--threads") && i + 1 < argc) {
+            o.threads = atoi(argv[++i]);
+        } else {
+            return usage();
+        }
+    }
+
+    PackStats stats;
+    string error;
+    auto t0 = chrono::steady_clock::now();
+    if (!writeBoardPack(path, o, stats, error)) {
+        cerr << error << endl;
+        return 1;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    char seed[32];
+    snprintf(seed, sizeof(seed), "%016llx", (unsigned long long)o.masterSeed);
+    cout << "已生成 " << stats.boards << " 个布局（" << o.rows << "x" << o.cols << "，" << o.mines << " 雷" << (o.noGuess ? "，无猜" : "")
+         << "，主种子 " << seed << "，" << WorkStealingPool::threadCount(o.threads) << " 个线程）" << endl;
+    cout << "用时 " << fixed << setprecision(3) << seconds << " 秒，" << setprecision(0) << stats.boards / seconds << " 个/秒，文件 "
+         << stats.bytes << " 字节（每个布局 " << setprecision(1) << (double)stats.bytes / max<uint64_t>(stats.boards, 1) << " 字节）" << endl;
+    if (o.noGuess) {
+        cout << "平均尝试 " << setprecision(2) << (double)stats.attempts / max<uint64_t>(stats.boards, 1) << " 次";
+        if (stats.failed) cout << "，" << stats.failed << " 个布局未能做到无猜";
+        cout << endl;
+    }
+    return 0;
+}
+
+static int info(int argc, char** argv) {
+    if (argc < 3) return usage();
+    PackReader reader;
+    string error;
+    if (!reader.open(argv[2], error)) {
+        cerr << error << endl;
+        return 1;
+    }
+    const PackHeader& h = reader.header();
+    char seed[32];
+    snprintf(seed, sizeof(seed), "%016llx", (unsigned long long)h.masterSeed);
+    cout << h.count << " 个布局，" << h.rows << "x" << h.cols << "，" << h.mines << " 雷" << ((h.flags & PACK_FLAG_NO_GUESS) ? "，无猜" : "")
+         << "，主种子 " << seed << endl;
+    BoardLayout layout;
+    int firstRow, firstCol;
+    uint64_t n = 0, bad = 0;
+    auto t0 = chrono::steady_clock::now();
+    while (reader.next(layout, firstRow, firstCol)) {
+        uint64_t mines = 0;
+        for (uint64_t w : layout.bits) mines += (uint64_t)popcount64(w);
+        bad += mines != h.mines;
+        n++;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    cout << "解码 " << n << " 个布局，用时 " << fixed << setprecision(3) << seconds * 1000 << " 毫秒" << endl;
+    if (n != h.count || bad) {
+        cerr << "布局包数据损坏：" << n << "/" << h.count << " 个可解码，" << bad << " 个雷数不符" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+static int extract(int argc, char** argv) {
+    if (argc < 5) return usage();
+    PackReader reader;
+    string error;
+    if (!reader.open(argv[2], error)) {
+        cerr << error << endl;
+        return 1;
+    }
+    uint64_t index = strtoull(argv[3], nullptr, 10);
+    BoardLayout layout;
+    int firstRow = -1, firstCol = -1;
+    for (uint64_t i = 0; i <= index; ++i) {
+        if (!reader.next(layout, firstRow, firstCol)) {
+            cerr << "布局包中没有第 " << index << " 个布局" << endl;
+            return 1;
+        }
+    }
+    if (firstRow < 0) {
+        if (!saveBoardBinary(argv[4], layout, error, smallestEncoding(layout))) {
+            cerr << error << endl;
+            return 1;
+        }
+        cout << "已保存到 " << argv[4] << endl;
+        return 0;
+    }
+    // 无猜布局只有从记录的格子开始才不需要猜：先揭示它，保存为对局快照
+    Game game;
+    game.create(layout.rows, layout.cols, layout.positions());
+    if (firstRow >= layout.rows || firstCol >= layout.cols || !game.reveal(firstRow, firstCol)) {
+        cerr << "布局包中第一次揭示的位置无效" << endl;
+        return 1;
+    }
+    SnapshotInfo info;
+    info.cursorRow = firstRow;
+    info.cursorCol = firstCol;
+    info.firstMove = false;
+    if (!saveGameSnapshot(argv[4], layout, game.board(), info, error, smallestEncoding(layout))) {
+        cerr << error << endl;
+        return 1;
+    }
+    cout << "已保存到 " << argv[4] << "，已揭示第一次揭示的格子 " << firstRow << " " << firstCol << endl;
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) return usage();
+    string command = argv[1];
+    if (command == "generate") return generate(argc, argv);
+    if (command == "info") return info(argc, argv);
+    if (command == "extract") return extract(argc, argv);
+    return usage();
+}
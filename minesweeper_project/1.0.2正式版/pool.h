@@ -0,0 +1,144 @@
+#pragma once
+
+// 工作窃取线程池：把下标区间 [0, count) 平均分给各线程，每个线程从自己区间的前端逐个取下标；
+// 自己的区间做完后，从剩余最多的线程那里偷走其区间的后一半。
+// 各下标耗时差别很大时（例如无猜布局的尝试次数），先做完的线程会自动分担别人的工作。
+// 线程在构造时创建、析构时结束，多次 run 之间复用；区间只在取下标和窃取时短暂加锁，冲突很少。
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class WorkStealingPool {
+public:
+    // threads 为 0 时使用全部硬件线程
+    explicit WorkStealingPool(int threads = 0) : ranges_(threadCount(threads)), generation_(0), active_(0), stop_(false) {
+        for (int t = 1; t < (int)ranges_.size(); ++t) {
+            workers_.emplace_back([this, t] { workerLoop(t); });
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto& w : workers_) w.join();
+    }
+
+    int threads() const { return (int)ranges_.size(); }
+
+    static int threadCount(int threads) {
+        return threads > 0 ? threads : (int)std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // 对 [0, count) 的每个 i 调用 fn(i, 线程编号)，全部完成后返回。调用线程自己是 0 号线程
+    void run(size_t count, const std::function<void(size_t, int)>& fn) {
+        size_t n = ranges_.size();
+        for (size_t t = 0; t < n; ++t) {
+            std::lock_guard<std::mutex> lock(ranges_[t].mutex);
+            ranges_[t].begin = count * t / n;
+            ranges_[t].end = count * (t + 1) / n;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            fn_ = &fn;
+            active_ = (int)n - 1;
+            generation_++;
+        }
+        wake_.notify_all();
+        work(0);
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return active_ == 0; });
+        fn_ = nullptr;
+    }
+
+private:
+    struct Range {
+        std::mutex mutex;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    void workerLoop(int t) {
+        size_t seen = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_) return;
+                seen = generation_;
+            }
+            work(t);
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--active_ == 0) done_.notify_one();
+        }
+    }
+
+    void work(int t) {
+        size_t i;
+        while (true) {
+            if (next(t, i)) {
+                (*fn_)(i, t);
+            } else if (!steal(t)) {
+                return;
+            }
+        }
+    }
+
+    // 从自己的区间前端取一个下标
+    bool next(int t, size_t& i) {
+        Range& r = ranges_[t];
+        std::lock_guard<std::mutex> lock(r.mutex);
+        if (r.begin >= r.end) return false;
+        i = r.begin++;
+        return true;
+    }
+
+    // 从剩余最多的线程偷走后一半放进自己的区间，没有可偷的返回 false
+    bool steal(int t) {
+        size_t n = ranges_.size();
+        while (true) {
+            size_t victim = n, most = 0;
+            for (size_t v = 0; v < n; ++v) {
+                if ((int)v == t) continue;
+                std::lock_guard<std::mutex> lock(ranges_[v].mutex);
+                size_t left = ranges_[v].end - std::min(ranges_[v].begin, ranges_[v].end);
+                if (left > most) {
+                    most = left;
+                    victim = v;
+                }
+            }
+            if (victim == n) return false;
+            size_t from, to;
+            {
+                std::lock_guard<std::mutex> lock(ranges_[victim].mutex);
+                Range& r = ranges_[victim];
+                if (r.begin >= r.end) continue; // 刚被做完或被别人偷走，重新挑选
+                size_t half = (r.end - r.begin + 1) / 2;
+                from = r.end - half;
+                to = r.end;
+                r.end = from;
+            }
+            std::lock_guard<std::mutex> lock(ranges_[t].mutex);
+            ranges_[t].begin = from;
+            ranges_[t].end = to;
+            return true;
+        }
+    }
+
+    std::vector<Range> ranges_;
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(size_t, int)>* fn_ = nullptr;
+    size_t generation_;
+    int active_;
+    bool stop_;
+};
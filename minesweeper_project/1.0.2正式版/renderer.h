@@ -0,0 +1,273 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "board.h"
+
+// 颜色定义 (ANSI 转义序列)
+const std::string COLOR_RESET = "\x1b[0m";
+const std::string COLOR_HIDDEN = "\x1b[37m";
+const std::string COLOR_REVEALED = "\x1b[32m";
+const std::string COLOR_FLAGGED = "\x1b[31m";
+const std::string COLOR_MINE = "\x1b[91m";
+const std::string COLOR_TIME = "\x1b[33m";
+
+// 可复用的帧缓冲区：容量只增不减，拼帧过程中不做任何格式化输出和内存分配
+class FrameBuffer {
+public:
+    FrameBuffer() : size_(0) {}
+
+    void clear() { size_ = 0; }
+    void reserve(size_t n) {
+        if (buf_.size() < n) buf_.resize(n);
+    }
+    void append(const char* s, size_t n) {
+        if (size_ + n > buf_.size()) buf_.resize((size_ + n) * 2);
+        memcpy(&buf_[size_], s, n);
+        size_ += n;
+    }
+    void append(const std::string& s) { append(s.data(), s.size()); }
+    void append(size_t count, char c) {
+        if (size_ + count > buf_.size()) buf_.resize((size_ + count) * 2);
+        memset(&buf_[size_], c, count);
+        size_ += count;
+    }
+    void push(char c) {
+        if (size_ == buf_.size()) buf_.resize(size_ * 2 + 64);
+        buf_[size_++] = c;
+    }
+
+    const char* data() const { return buf_.data(); }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    std::vector<char> buf_;
+    size_t size_;
+};
+
+// 差分渲染器：保存上一帧每个格子显示的内容（影子帧），
+// 之后每帧只为发生变化的格子输出光标定位序列和新字符，移动光标只会改动两个格子。
+// 整帧拼进一个可复用的缓冲区再一次写出；颜色只在与前一个字符不同时才输出转义序列，
+// 同色的连续格子共用一个颜色序列。
+class Renderer {
+public:
+    Renderer() : rows_(0), cols_(0), colour_(COLOUR_DEFAULT), termLine_(0), termColumn_(0),
+                 lastFrameBytes_(0), frames_(0), totalBytes_(0) {}
+
+    // 丢弃影子帧，下一帧清屏后整屏重绘。
+    // 画面被其他输出打乱（菜单、提示文字）或开始新的一局时调用
+    void invalidate() { shadow_.clear(); }
+
+    // 生成一帧到内部缓冲区并返回，不写出。基准测试直接使用这个接口
+    const FrameBuffer& compose(const Board& board, bool showMines, double elapsedTime, int cursorRow, int cursorCol) {
+        frame_.clear();
+        colour_ = COLOUR_DEFAULT;
+        bool full = shadow_.empty() || rows_ != board.rows() || cols_ != board.cols();
+        if (full) {
+            rows_ = board.rows();
+            cols_ = board.cols();
+            shadow_.assign((size_t)rows_ * cols_, 0);
+            header_.clear();
+            // 最坏情况：每格 3 个字符加一个颜色序列，每行再加行号、边框和一次颜色复位
+            frame_.reserve((size_t)rows_ * (cols_ * 8 + 24) + (size_t)cols_ * 16 + 256);
+            composeFull(board, showMines, elapsedTime, cursorRow, cursorCol);
+        } else {
+            composeDiff(board, showMines, elapsedTime, cursorRow, cursorCol);
+        }
+        lastFrameBytes_ = frame_.size();
+        frames_++;
+        totalBytes_ += (long long)frame_.size();
+        return frame_;
+    }
+
+    // 生成并一次性写出一帧
+    void draw(const Board& board, bool showMines, double elapsedTime, int cursorRow, int cursorCol) {
+        const FrameBuffer& out = compose(board, showMines, elapsedTime, cursorRow, cursorCol);
+        fwrite(out.data(), 1, out.size(), stdout);
+        fflush(stdout);
+    }
+
+    // 字节数统计
+    void resetStats() { lastFrameBytes_ = 0; frames_ = 0; totalBytes_ = 0; }
+    size_t lastFrameBytes() const { return lastFrameBytes_; }
+    long long frames() const { return frames_; }
+    long long totalBytes() const { return totalBytes_; }
+
+private:
+    // 格子显示代码：低 4 位 0-8 为数字（0 显示空格），其余见下；第 4 位表示光标在此格
+    enum { GLYPH_MINE = 9, GLYPH_FLAG = 10, GLYPH_HIDDEN = 11, CURSOR_BIT = 0x10 };
+    // 当前终端前景色
+    enum Colour { COLOUR_DEFAULT, COLOUR_HIDDEN, COLOUR_REVEALED, COLOUR_FLAGGED, COLOUR_MINE };
+
+    static uint8_t cellCode(const Board& board, int i, int j, bool showMines, int cursorRow, int cursorCol) {
+        int idx = board.index(i, j);
+        CellStatus st = board.statusAt(idx);
+        uint8_t code;
+        if (st == REVEALED || showMines) {
+            code = board.isMine(idx) ? (uint8_t)GLYPH_MINE : (uint8_t)board.adjacent(idx);
+        } else if (st == FLAGGED) {
+            code = GLYPH_FLAG;
+        } else {
+            code = GLYPH_HIDDEN;
+        }
+        if (i == cursorRow && j == cursorCol) {
+            code |= CURSOR_BIT;
+        }
+        return code;
+    }
+
+    void setColour(Colour c) {
+        if (c == colour_) return;
+        colour_ = c;
+        switch (c) {
+            case COLOUR_DEFAULT: frame_.append(COLOR_RESET); break;
+            case COLOUR_HIDDEN: frame_.append(COLOR_HIDDEN); break;
+            case COLOUR_REVEALED: frame_.append(COLOR_REVEALED); break;
+            case COLOUR_FLAGGED: frame_.append(COLOR_FLAGGED); break;
+            case COLOUR_MINE: frame_.append(COLOR_MINE); break;
+        }
+    }
+
+    // 一个格子占 3 列：光标左括号、带颜色的字符、光标右括号。
+    // 没有光标时两侧是空格，空格不受颜色影响，整段同色格子只需一个颜色序列
+    void appendCell(uint8_t code) {
+        bool cursor = (code & CURSOR_BIT) != 0;
+        if (cursor) {
+            setColour(COLOUR_DEFAULT);
+            frame_.push('[');
+        } else {
+            frame_.push(' ');
+        }
+        int glyph = code & 0x0F;
+        if (glyph == GLYPH_MINE) {
+            setColour(COLOUR_MINE);
+            frame_.push('*');
+        } else if (glyph == GLYPH_FLAG) {
+            setColour(COLOUR_FLAGGED);
+            frame_.push('F');
+        } else if (glyph == GLYPH_HIDDEN) {
+            setColour(COLOUR_HIDDEN);
+            frame_.push('.');
+        } else if (glyph == 0) {
+            frame_.push(' '); // 空白格不需要颜色
+        } else {
+            setColour(COLOUR_REVEALED);
+            frame_.push((char)('0' + glyph));
+        }
+        if (cursor) {
+            setColour(COLOUR_DEFAULT);
+            frame_.push(']');
+        } else {
+            frame_.push(' ');
+        }
+    }
+
+    // 光标定位到第 line 行第 column 列（均从 1 开始）；终端光标已在该处时不输出
+    void moveTo(int line, int column) {
+        if (line == termLine_ && column == termColumn_) return;
+        char buf[32];
+        int n = snprintf(buf, sizeof(buf), "\x1b[%d;%dH", line, column);
+        frame_.append(buf, n);
+        termLine_ = line;
+        termColumn_ = column;
+    }
+
+    // 游戏进行中按整秒刷新，结束画面显示精确用时
+    std::string headerText(const Board& board, bool showMines, double elapsedTime) const {
+        char buf[128];
+        snprintf(buf, sizeof(buf), "用时：%.*f 秒  剩余雷数：%d", showMines ? 2 : 0, elapsedTime, board.stats().minesLeft);
+        return COLOR_TIME + buf + COLOR_RESET;
+    }
+
+    // 第 i 行左侧行号与边框的宽度，与 setw(2) << i << "|" 一致
+    static int rowPrefixWidth(int i) {
+        int digits = 1;
+        for (int v = i; v >= 10; v /= 10) digits++;
+        return (digits < 2 ? 2 : digits) + 1;
+    }
+
+    void appendBorderLine() {
+        int colWidth = (int)std::to_string(cols_ - 1).length() + 1;
+        frame_.append(" +", 2);
+        frame_.append(colWidth * cols_ - 1, '-');
+        frame_.append("+\n", 2);
+    }
+
+    void composeFull(const Board& board, bool showMines, double elapsedTime, int cursorRow, int cursorCol) {
+        frame_.append("\x1b[H\x1b[2J", 7); // 清屏
+        header_ = headerText(board, showMines, elapsedTime);
+        frame_.append(header_);
+        frame_.push('\n');
+
+        // 列号
+        int colWidth = (int)std::to_string(cols_ - 1).length() + 1;
+        frame_.append("   ", 3); // 三个空格用于对齐行号
+        for (int j = 0; j < cols_; ++j) {
+            std::string num = std::to_string(j);
+            frame_.append(colWidth - num.size(), ' ');
+            frame_.append(num);
+        }
+        frame_.push('\n');
+        appendBorderLine();
+
+        for (int i = 0; i < rows_; ++i) {
+            char buf[16];
+            int n = snprintf(buf, sizeof(buf), "%2d|", i);
+            frame_.append(buf, n);
+            for (int j = 0; j < cols_; ++j) {
+                uint8_t code = cellCode(board, i, j, showMines, cursorRow, cursorCol);
+                shadow_[(size_t)i * cols_ + j] = code;
+                appendCell(code);
+            }
+            setColour(COLOUR_DEFAULT); // 边框用默认颜色
+            frame_.append("|\n", 2);
+        }
+        appendBorderLine();
+    }
+
+    void composeDiff(const Board& board, bool showMines, double elapsedTime, int cursorRow, int cursorCol) {
+        termLine_ = 0; // 上一帧之后终端光标位置未知
+        std::string header = headerText(board, showMines, elapsedTime);
+        if (header != header_) {
+            header_ = header;
+            moveTo(1, 1);
+            frame_.append(header_);
+            frame_.append("\x1b[K", 3); // 清除行尾残留
+            termLine_ = 0;
+        }
+        for (int i = 0; i < rows_; ++i) {
+            int prefix = rowPrefixWidth(i);
+            for (int j = 0; j < cols_; ++j) {
+                uint8_t code = cellCode(board, i, j, showMines, cursorRow, cursorCol);
+                uint8_t& old = shadow_[(size_t)i * cols_ + j];
+                if (code != old) {
+                    old = code;
+                    moveTo(4 + i, prefix + 3 * j + 1); // 前三行为计时、列号和上边框；相邻格子不必重复定位
+                    appendCell(code);
+                    termColumn_ += 3;
+                }
+            }
+        }
+        if (!frame_.empty()) {
+            setColour(COLOUR_DEFAULT);
+            moveTo(rows_ + 5, 1); // 把终端光标放回棋盘下方，后续文字输出不会覆盖棋盘
+        }
+    }
+
+    int rows_;
+    int cols_;
+    std::vector<uint8_t> shadow_;
+    std::string header_;
+    FrameBuffer frame_;
+    Colour colour_;
+    int termLine_;   // 拼帧过程中终端光标所在行，0 表示未知
+    int termColumn_;
+    size_t lastFrameBytes_;
+    long long frames_;
+    long long totalBytes_;
+};
@@ -0,0 +1,200 @@
+#pragma once
+
+// 事件日志回放：按日志中的事件顺序重新执行揭示、标记和双击，核对每局的结果。
+//
+// 布局由 EV_GAME_START 中的种子重新生成，种子未知时用紧跟其后的 EV_LAYOUT，
+// 有 EV_DEFERRED_LAYOUT（或 EV_NO_GUESS_LAYOUT）时与游戏中一样在第一次揭示时生成；
+// 从快照继续的对局（EV_RESUME）读取快照文件恢复进度。不做任何输入输出，
+// 结束事件（EV_GAME_OVER、EV_QUIT）中记录的胜负和棋盘校验和与重新执行的结果逐局比较，
+// 棋盘的每个字节都一致才算通过。
+
+#include <string>
+#include <vector>
+
+#include "boardfile.h"
+#include "eventlog.h"
+#include "game.h"
+#include "generator.h"
+#include "rice.h"
+
+// 一局回放的结局
+enum ReplayEnd { REPLAY_WON, REPLAY_LOST, REPLAY_QUIT, REPLAY_UNFINISHED };
+
+// 一局回放的结果
+struct ReplayResult {
+    int rows = 0;
+    int cols = 0;
+    int mines = 0;
+    uint64_t seed = 0;
+    uint64_t startTime = 0; // 开局的 Unix 时间
+    long long actions = 0;  // 重新执行的揭示、标记和双击次数
+    ReplayEnd end = REPLAY_UNFINISHED;
+    bool verified = false; // 结局和棋盘校验和与日志一致
+    std::string error;     // 无法回放或与日志不一致的原因
+};
+
+// 绝对路径：以 / 或 \ 开头，或带盘符（Windows）
+inline bool replayAbsolutePath(const std::string& path) {
+    if (!path.empty() && (path[0] == '/' || path[0] == '\\')) return true;
+    return path.size() >= 2 && path[1] == ':';
+}
+
+class Replayer {
+public:
+    // 日志中的快照文件名是游戏打开或写入时的原样路径。游戏把日志写在工作目录，
+    // 相对路径就相对于日志文件所在的目录，拼在 snapshotDir 之后；绝对路径直接使用
+    explicit Replayer(const std::string& snapshotDir = "") : snapshotDir_(snapshotDir), active_(false), cursorRow_(0), cursorCol_(0) {}
+
+    // 处理一条事件，返回 true 表示局面或光标变化（需要重绘）
+    bool apply(const LogEvent& e) {
+        switch (e.type) {
+            case EV_GAME_START:
+                finish();
+                start(e);
+                return active_;
+            case EV_LAYOUT:
+                if (!results_.empty() && !active_ && results_.back().end == REPLAY_UNFINISHED && results_.back().error.empty()) {
+                    startFromLayout(e);
+                }
+                return active_;
+            default:
+                break;
+        }
+        if (!active_) return false;
+        ReplayResult& r = results_.back();
+        switch (e.type) {
+            case EV_MOVE_UP:
+                cursorRow_ = (cursorRow_ - 1 + game_.rows()) % game_.rows();
+                return true;
+            case EV_MOVE_DOWN:
+                cursorRow_ = (cursorRow_ + 1) % game_.rows();
+                return true;
+            case EV_MOVE_LEFT:
+                cursorCol_ = (cursorCol_ - 1 + game_.cols()) % game_.cols();
+                return true;
+            case EV_MOVE_RIGHT:
+                cursorCol_ = (cursorCol_ + 1) % game_.cols();
+                return true;
+            case EV_FLAG:
+                game_.toggleFlag(e.row, e.col);
+                r.actions++;
+                return true;
+            case EV_REVEAL:
+                game_.reveal(e.row, e.col);
+                r.actions++;
+                return true;
+            case EV_CHORD:
+                game_.chord(e.row, e.col);
+                r.actions++;
+                return true;
+            case EV_DEFERRED_LAYOUT:
+            case EV_NO_GUESS_LAYOUT:
+                game_.createDeferred(r.rows, r.cols, r.mines, r.seed, e.type == EV_NO_GUESS_LAYOUT);
+                return true;
+            case EV_SAVE:
+                game_.generateNow(); // 与游戏中一样，还没揭示过就保存时布局按种子确定
+                return false;
+            case EV_RESUME:
+                resume(e);
+                return true;
+            case EV_QUIT:
+                end(REPLAY_QUIT, game_.state() == PLAYING, e.hash);
+                return false;
+            case EV_GAME_OVER:
+                end(e.value ? REPLAY_WON : REPLAY_LOST, game_.state() == (e.value ? WON : LOST), e.hash);
+                return false;
+            default:
+                return false;
+        }
+    }
+
+    // 日志读完后调用：最后一局没有结束事件时记为未结束
+    void finish() {
+        if (!results_.empty() && results_.back().end == REPLAY_UNFINISHED && results_.back().error.empty()) {
+            results_.back().error = "日志中没有结束事件";
+        }
+        active_ = false;
+    }
+
+    const std::vector<ReplayResult>& results() const { return results_; }
+    const Game& game() const { return game_; }
+    bool active() const { return active_; }
+    int cursorRow() const { return cursorRow_; }
+    int cursorCol() const { return cursorCol_; }
+
+private:
+    // 防止损坏的日志申请过大的棋盘
+    static const int MAX_SIDE = 1 << 15;
+
+    void start(const LogEvent& e) {
+        results_.emplace_back();
+        ReplayResult& r = results_.back();
+        r.rows = e.row;
+        r.cols = e.col;
+        r.mines = (int)e.extra;
+        r.seed = e.seed;
+        r.startTime = e.value;
+        cursorRow_ = 0;
+        cursorCol_ = 0;
+        long long cells = (long long)r.rows * r.cols;
+        if (r.rows <= 0 || r.cols <= 0 || r.rows > MAX_SIDE || r.cols > MAX_SIDE || r.mines <= 0 || r.mines >= cells) {
+            r.error = "开局事件中的棋盘大小无效";
+            return;
+        }
+        if (r.seed == 0) return; // 等待 EV_LAYOUT
+        game_.create(r.rows, r.cols, bitmapToPositions(generateMines((uint32_t)cells, (uint32_t)r.mines, r.seed), r.cols));
+        active_ = true;
+    }
+
+    void startFromLayout(const LogEvent& e) {
+        ReplayResult& r = results_.back();
+        BoardLayout layout;
+        layout.rows = r.rows;
+        layout.cols = r.cols;
+        layout.mines = r.mines;
+        if (!riceDecode(e.blob.data(), e.blob.size(), (uint32_t)r.rows * (uint32_t)r.cols, (uint32_t)r.mines, layout.bits)) {
+            r.error = "布局数据损坏";
+            return;
+        }
+        game_.create(r.rows, r.cols, layout.positions());
+        active_ = true;
+    }
+
+    void resume(const LogEvent& e) {
+        ReplayResult& r = results_.back();
+        BoardLayout layout;
+        std::string error;
+        std::string path = snapshotDir_.empty() || replayAbsolutePath(e.text) ? e.text : snapshotDir_ + "/" + e.text;
+        if (!loadBoardFile(path, layout, error) || !layout.hasSnapshot) {
+            r.error = "无法读取快照 " + e.text;
+            active_ = false;
+            return;
+        }
+        if (layout.rows != r.rows || layout.cols != r.cols || !game_.restoreStatus(layout.statusPlanes, layout.statusWords)) {
+            r.error = "快照 " + e.text + " 与日志中的对局不符";
+            active_ = false;
+            return;
+        }
+        cursorRow_ = layout.snapshot.cursorRow;
+        cursorCol_ = layout.snapshot.cursorCol;
+    }
+
+    void end(ReplayEnd how, bool stateMatches, uint64_t hash) {
+        ReplayResult& r = results_.back();
+        r.end = how;
+        r.verified = stateMatches && boardHash(game_.board()) == hash;
+        if (!stateMatches) {
+            r.error = "结局与日志不一致";
+        } else if (!r.verified) {
+            r.error = "棋盘与日志不一致";
+        }
+        active_ = false;
+    }
+
+    std::string snapshotDir_;
+    std::vector<ReplayResult> results_;
+    Game game_;
+    bool active_;
+    int cursorRow_;
+    int cursorCol_;
+};
@@ -0,0 +1,213 @@
+#pragma once
+
+// 雷位置的压缩编码：把雷的格子编号按升序写成间隔（相邻两个雷之间的安全格数），
+// 再用 Rice 编码（Golomb 编码的参数取 2 的幂）写入位流：
+// 间隔 g 拆成商 q = g >> k 和余数 g 的低 k 位，商用一元码（q 个 0 后跟一个 1），余数原样写出。
+// 随机布局的间隔近似服从几何分布，Rice 编码对几何分布接近最优。
+// 雷密度超过一半时改为编码安全格的位置。位流按字节从低位到高位排列。
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "generator.h"
+
+// 位流写入
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out_(out), acc_(0), bits_(0) {}
+
+    // 写出 value 的低 count 位，count 不超过 32
+    void put(uint32_t value, int count) {
+        acc_ |= (uint64_t)value << bits_;
+        bits_ += count;
+        while (bits_ >= 8) {
+            out_.push_back((uint8_t)acc_);
+            acc_ >>= 8;
+            bits_ -= 8;
+        }
+    }
+
+    // q 个 0 后跟一个 1
+    void putUnary(uint64_t q) {
+        for (; q >= 32; q -= 32) put(0, 32);
+        put(1u << q, (int)q + 1);
+    }
+
+    // 补齐最后一个字节
+    void flush() {
+        if (bits_ > 0) out_.push_back((uint8_t)acc_);
+        acc_ = 0;
+        bits_ = 0;
+    }
+
+private:
+    std::vector<uint8_t>& out_;
+    uint64_t acc_;
+    int bits_;
+};
+
+// 位流读取，直接读调用方给的内存（例如映射的文件），读到末尾之后的请求返回 false
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : p_(data), end_(data + size), acc_(0), bits_(0) {}
+
+    bool getUnary(uint64_t& q) {
+        q = 0;
+        while (true) {
+            refill();
+            if (bits_ == 0) return false;
+            if (acc_ == 0) { // 缓冲中全是 0
+                q += bits_;
+                bits_ = 0;
+                continue;
+            }
+            int zeros = lowestBit(acc_);
+            q += zeros;
+            acc_ >>= zeros + 1;
+            bits_ -= zeros + 1;
+            return true;
+        }
+    }
+
+    bool get(int count, uint32_t& value) {
+        refill();
+        if (bits_ < count) return false;
+        value = (uint32_t)(acc_ & (((uint64_t)1 << count) - 1));
+        acc_ >>= count;
+        bits_ -= count;
+        return true;
+    }
+
+private:
+    // 缓冲区最多保留 63 位，移位量始终小于 64
+    void refill() {
+        while (bits_ <= 55 && p_ < end_) {
+            acc_ |= (uint64_t)*p_++ << bits_;
+            bits_ += 8;
+        }
+    }
+
+    const uint8_t* p_;
+    const uint8_t* end_;
+    uint64_t acc_;
+    int bits_;
+};
+
+// 对平均间隔为 mean 的几何分布，最优的 Rice 参数
+inline int riceParameter(double mean) {
+    if (mean < 1) return 0;
+    const double golden = 0.6180339887498949; // 黄金分割比 - 1
+    int k = 1 + (int)std::floor(std::log2(std::log(golden) / std::log(mean / (mean + 1))));
+    return k < 0 ? 0 : k > 30 ? 30 : k;
+}
+
+// 编码头：第 0 字节为 Rice 参数 k，第 1 字节 bit 0 表示编码的是安全格
+const int RICE_HEADER_BYTES = 2;
+const uint8_t RICE_COMPLEMENT = 1;
+
+// 按位图中的雷（或安全格）计算编码参数
+inline void riceChoose(uint32_t cellCount, uint32_t mines, bool& complement, int& k) {
+    complement = (uint64_t)mines * 2 > cellCount;
+    uint32_t count = complement ? cellCount - mines : mines;
+    k = count ? riceParameter((double)(cellCount - count) / count) : 0;
+}
+
+// 编码后的字节数，不实际编码
+inline uint64_t riceEncodedSize(const MineBitmap& bits, uint32_t cellCount, uint32_t mines) {
+    bool complement;
+    int k;
+    riceChoose(cellCount, mines, complement, k);
+    uint64_t total = 0;
+    int64_t prev = -1;
+    for (size_t w = 0; w < bits.size(); ++w) {
+        uint64_t word = complement ? ~bits[w] : bits[w];
+        if (complement && w + 1 == bits.size() && cellCount % 64) {
+            word &= ((uint64_t)1 << (cellCount % 64)) - 1;
+        }
+        while (word) {
+            int64_t i = (int64_t)(w * 64 + lowestBit(word));
+            uint64_t gap = (uint64_t)(i - prev - 1);
+            total += (gap >> k) + 1 + k;
+            prev = i;
+            word &= word - 1;
+        }
+    }
+    return RICE_HEADER_BYTES + (total + 7) / 8;
+}
+
+// 把位图编码为 Rice 间隔流
+inline void riceEncode(const MineBitmap& bits, uint32_t cellCount, uint32_t mines, std::vector<uint8_t>& out) {
+    bool complement;
+    int k;
+    riceChoose(cellCount, mines, complement, k);
+    out.clear();
+    out.push_back((uint8_t)k);
+    out.push_back(complement ? RICE_COMPLEMENT : 0);
+    BitWriter writer(out);
+    int64_t prev = -1;
+    for (size_t w = 0; w < bits.size(); ++w) {
+        uint64_t word = complement ? ~bits[w] : bits[w];
+        if (complement && w + 1 == bits.size() && cellCount % 64) {
+            word &= ((uint64_t)1 << (cellCount % 64)) - 1;
+        }
+        while (word) {
+            int64_t i = (int64_t)(w * 64 + lowestBit(word));
+            uint64_t gap = (uint64_t)(i - prev - 1);
+            writer.putUnary(gap >> k);
+            if (k > 0) writer.put((uint32_t)(gap & ((1u << k) - 1)), k);
+            prev = i;
+            word &= word - 1;
+        }
+    }
+    writer.flush();
+}
+
+// 边读边解码，每次给出下一个雷（或安全格）的格子编号，不需要先把整个列表解出来
+class RiceDecoder {
+public:
+    RiceDecoder(const uint8_t* data, size_t size)
+        : reader_(data + (size >= RICE_HEADER_BYTES ? RICE_HEADER_BYTES : size), size >= RICE_HEADER_BYTES ? size - RICE_HEADER_BYTES : 0),
+          k_(size >= RICE_HEADER_BYTES ? data[0] : 0),
+          complement_(size >= RICE_HEADER_BYTES && (data[1] & RICE_COMPLEMENT)),
+          valid_(size >= RICE_HEADER_BYTES && data[0] <= 30),
+          next_(0) {}
+
+    bool valid() const { return valid_; }
+    bool complement() const { return complement_; }
+
+    // 读出下一个编号，数据不足时返回 false
+    bool next(uint64_t& index) {
+        uint64_t q;
+        uint32_t r = 0;
+        if (!reader_.getUnary(q) || (k_ > 0 && !reader_.get(k_, r))) return false;
+        index = next_ + (q << k_) + r;
+        next_ = index + 1;
+        return true;
+    }
+
+private:
+    BitReader reader_;
+    int k_;
+    bool complement_;
+    bool valid_;
+    uint64_t next_;
+};
+
+// 把 Rice 流直接解码进位图，流中应有 mines 个雷（编码安全格时为 cellCount - mines 个安全格）
+inline bool riceDecode(const uint8_t* data, size_t size, uint32_t cellCount, uint32_t mines, MineBitmap& bits) {
+    RiceDecoder decoder(data, size);
+    if (!decoder.valid()) return false;
+    uint32_t count = decoder.complement() ? cellCount - mines : mines;
+    bits.assign((cellCount + 63) / 64, 0);
+    for (uint32_t n = 0; n < count; ++n) {
+        uint64_t i;
+        if (!decoder.next(i) || i >= cellCount) return false;
+        setBit(bits, i);
+    }
+    if (decoder.complement()) {
+        for (auto& w : bits) w = ~w;
+        if (cellCount % 64) bits.back() &= ((uint64_t)1 << (cellCount % 64)) - 1;
+    }
+    return true;
+}
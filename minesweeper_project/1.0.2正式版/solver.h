@@ -0,0 +1,218 @@
+#pragma once
+
+// 逻辑求解器和无猜布局生成。
+//
+// 求解器只根据玩家看得到的信息（已揭示的数字、旗子、总雷数）推理，不猜，按代价从低到高使用三条规则：
+//   1. 单格规则：数字减去周围旗数为 0 时，周围其余隐藏格都安全；等于周围隐藏格数时都是雷
+//   2. 子集规则：数字格 A 周围的未知格都在数字格 B 周围时，B 多出来的未知格里恰有 need(B) - need(A) 个雷，
+//      这个差为 0 时多出来的格子都安全，等于多出来的格数时都是雷
+//   3. 总雷数：旗数等于总雷数时，其余隐藏格都安全
+// 推出的雷直接插旗、安全格直接揭示，所以要在真实棋盘上运行，棋盘上已有的旗必须都插对
+// （生成器和机器人都在自己的 Board 上运行）。单格规则用工作队列，只重新检查约束发生变化的数字格。
+
+#include <cstdint>
+#include <vector>
+
+#include "board.h"
+#include "generator.h"
+
+class Solver {
+public:
+    // 在 board 上推理到无法继续为止，返回 true 表示所有安全格都已揭示
+    bool solve(Board& board) {
+        board_ = &board;
+        cells_ = board.data();
+        nb_ = board.neighbours();
+        int stride = board.stride();
+        int k = 0;
+        for (int dr = -2; dr <= 2; ++dr) {
+            for (int dc = -2; dc <= 2; ++dc) {
+                if (dr != 0 || dc != 0) window_[k++] = dr * stride + dc;
+            }
+        }
+        queued_.assign((size_t)(board.rows() + 2) * stride, 0);
+        queue_.clear();
+        frontier_.clear();
+        for (int i = 0; i < board.rows(); ++i) {
+            for (int j = 0; j < board.cols(); ++j) {
+                int idx = board.index(i, j);
+                if (isNumber(idx)) {
+                    frontier_.push_back(idx);
+                    enqueue(idx);
+                }
+            }
+        }
+        while (true) {
+            propagate();
+            if (board.hiddenSafe() == 0) return true;
+            if (subsetPass() || mineCountPass()) continue;
+            return false;
+        }
+    }
+
+private:
+    // 已揭示的数字格（不含边框）
+    bool isNumber(int idx) const {
+        uint8_t c = cells_[idx];
+        return (c & (Board::BORDER_BIT | Board::STATUS_MASK)) == Board::REVEALED_BITS && (c & Board::COUNT_MASK) != 0;
+    }
+    bool isUnknown(int idx) const { return (cells_[idx] & Board::STATUS_MASK) == 0; } // 隐藏且未插旗
+
+    // 周围的未知格写入 unknown，返回还需要的雷数（数字减去周围旗数）
+    int constraint(int idx, int* unknown, int& count) const {
+        int flags = 0;
+        count = 0;
+        for (int k = 0; k < 8; ++k) {
+            int n = idx + nb_[k];
+            uint8_t st = cells_[n] & Board::STATUS_MASK;
+            if (st == 0) unknown[count++] = n;
+            flags += st == Board::FLAGGED_BITS;
+        }
+        return (cells_[idx] & Board::COUNT_MASK) - flags;
+    }
+
+    void enqueue(int idx) {
+        if (!queued_[idx]) {
+            queued_[idx] = 1;
+            queue_.push_back(idx);
+        }
+    }
+
+    // idx 变化后，周围数字格的约束需要重新检查
+    void touch(int idx) {
+        for (int k = 0; k < 8; ++k) {
+            int n = idx + nb_[k];
+            if (isNumber(n)) enqueue(n);
+        }
+    }
+
+    void reveal(int idx) {
+        if (!isUnknown(idx)) return;
+        revealed_.clear();
+        board_->reveal(idx, revealed_);
+        for (int r : revealed_) {
+            if (isNumber(r)) {
+                frontier_.push_back(r);
+                enqueue(r);
+            }
+            touch(r);
+        }
+    }
+
+    void flag(int idx) {
+        if (!isUnknown(idx)) return;
+        board_->toggleFlag(idx);
+        touch(idx);
+    }
+
+    // 规则 1，直到队列为空
+    void propagate() {
+        int unknown[8];
+        while (!queue_.empty()) {
+            int a = queue_.back();
+            queue_.pop_back();
+            queued_[a] = 0;
+            int count;
+            int need = constraint(a, unknown, count);
+            if (count == 0) continue;
+            if (need == 0) {
+                for (int k = 0; k < count; ++k) reveal(unknown[k]);
+            } else if (need == count) {
+                for (int k = 0; k < count; ++k) flag(unknown[k]);
+            }
+        }
+    }
+
+    bool adjacentTo(int a, int b) const {
+        int stride = board_->stride();
+        int dr = a / stride - b / stride, dc = a % stride - b % stride;
+        return dr >= -1 && dr <= 1 && dc >= -1 && dc <= 1;
+    }
+
+    // 规则 2：对每个边界上的数字格 A，检查 5x5 范围内可能包含它的数字格 B。
+    // 推出的结论立即执行，同一遍中后面的比较基于最新局面
+    bool subsetPass() {
+        bool progress = false;
+        int unknownA[8], unknownB[8];
+        size_t kept = 0;
+        for (size_t f = 0; f < frontier_.size(); ++f) {
+            int a = frontier_[f];
+            int countA;
+            int needA = constraint(a, unknownA, countA);
+            if (countA == 0) continue; // 周围已全部确定，移出边界
+            frontier_[kept++] = a;
+            for (int w = 0; w < 24; ++w) {
+                int b = a + window_[w];
+                if (!isNumber(b)) continue;
+                int countB;
+                int needB = constraint(b, unknownB, countB);
+                if (countB <= countA) continue;
+                bool subset = true;
+                for (int k = 0; k < countA && subset; ++k) subset = adjacentTo(unknownA[k], b);
+                if (!subset) continue;
+                int extra = countB - countA, extraMines = needB - needA;
+                if (extraMines != 0 && extraMines != extra) continue;
+                for (int k = 0; k < countB; ++k) {
+                    if (adjacentTo(unknownB[k], a)) continue; // 属于 A 的未知格
+                    if (extraMines == 0) reveal(unknownB[k]);
+                    else flag(unknownB[k]);
+                }
+                progress = true;
+                needA = constraint(a, unknownA, countA);
+                if (countA == 0) break;
+            }
+        }
+        frontier_.resize(kept);
+        return progress;
+    }
+
+    // 规则 3
+    bool mineCountPass() {
+        BoardStats s = board_->stats();
+        if (s.flags != s.mines) return false;
+        for (int i = 0; i < board_->rows(); ++i) {
+            for (int j = 0; j < board_->cols(); ++j) {
+                reveal(board_->index(i, j));
+            }
+        }
+        return true;
+    }
+
+    Board* board_ = nullptr;
+    const uint8_t* cells_ = nullptr;
+    const int* nb_ = nullptr;
+    int window_[24];
+    std::vector<uint8_t> queued_;
+    std::vector<int> queue_;    // 约束待检查的数字格
+    std::vector<int> frontier_; // 可能还有未知邻居的数字格
+    std::vector<int> revealed_;
+};
+
+// 无猜布局的默认尝试次数，雷太密时可能始终找不到
+const int NO_GUESS_MAX_ATTEMPTS = 1000;
+
+// 无猜布局：从第一次揭示 (safeRow, safeCol) 开始只靠 Solver 的推理就能揭开全部安全格。
+// 拒绝采样：第 k 次尝试用种子 CounterRng(seed).at(k) 生成避开第一次揭示 3x3 的布局（generateMinesAvoiding），
+// 求解不了就换下一个种子，布局完全由 (行, 列, 雷数, 种子, 第一次揭示) 决定。
+// maxAttempts 次都需要猜时返回 false，bits 为最后一次尝试的布局。attempts 返回用掉的尝试次数
+inline bool generateNoGuess(int rows, int cols, uint32_t mines, uint64_t seed, int safeRow, int safeCol, MineBitmap& bits,
+                            int maxAttempts = NO_GUESS_MAX_ATTEMPTS, int* attempts = nullptr) {
+    CounterRng seeds(seed);
+    Board board;
+    Solver solver;
+    std::vector<int> revealed;
+    bool solved = false;
+    int k = 0;
+    while (k < maxAttempts && !solved) {
+        bits = generateMinesAvoiding(rows, cols, mines, seeds.at((uint64_t)k++), safeRow, safeCol);
+        board.reset(rows, cols);
+        for (const auto& pos : bitmapToPositions(bits, cols)) {
+            board.setMine(board.index(pos.first, pos.second));
+        }
+        board.computeAdjacency();
+        revealed.clear();
+        solved = board.reveal(board.index(safeRow, safeCol), revealed) && solver.solve(board);
+    }
+    if (attempts) *attempts = k;
+    return solved;
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+// 终端抽象：按键读取、带超时的等待和原始模式切换。
+// Windows 使用控制台 API 和 conio；其他平台使用 termios 原始模式和 poll()，
+// 方向键的转义序列在这里统一解码，游戏逻辑只看到下面的按键代码。
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <conio.h>
+#else
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+// 按键代码：普通字符直接返回字符本身，回车统一为 KEY_ENTER，
+// 方向键为 KEY_UP 等；无法识别的扩展键为 KEY_EXTENDED + 扫描码/序列末字符
+enum {
+    KEY_ENTER = 13,
+    KEY_ESC = 27,
+    KEY_UP = 0x100,
+    KEY_DOWN,
+    KEY_LEFT,
+    KEY_RIGHT,
+    KEY_EXTENDED = 0x200
+};
+
+#ifdef _WIN32
+
+inline void terminalInit() {
+    HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
+    if (hOut != INVALID_HANDLE_VALUE) {
+        DWORD dwMode = 0;
+        if (GetConsoleMode(hOut, &dwMode)) {
+            dwMode |= ENABLE_VIRTUAL_TERMINAL_PROCESSING;
+            SetConsoleMode(hOut, dwMode);
+        }
+    }
+}
+
+// Windows 控制台下 _getch 本身就是逐键读取，不需要切换模式
+class RawMode {
+public:
+    void restore() {}
+};
+
+// 阻塞等待按键，最多等待 timeoutMs 毫秒（小于 0 表示一直等待）。有按键可读时返回 true
+inline bool waitForKey(int timeoutMs) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    HANDLE hIn = GetStdHandle(STD_INPUT_HANDLE);
+    while (!_kbhit()) {
+        DWORD wait = INFINITE;
+        if (timeoutMs >= 0) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            if (left <= 0) {
+                return false;
+            }
+            wait = (DWORD)left;
+        }
+        if (WaitForSingleObject(hIn, wait) != WAIT_OBJECT_0) {
+            return _kbhit() != 0; // 超时
+        }
+        // 鼠标、焦点、按键弹起等事件也会唤醒等待；_kbhit 为假说明缓冲区里没有字符，直接丢弃
+        if (!_kbhit()) {
+            FlushConsoleInputBuffer(hIn);
+        }
+    }
+    return true;
+}
+
+// 读取一个按键（阻塞）
+inline int readKey() {
+    int ch = _getch();
+    if (ch == 0xE0 || ch == 0) { // 扩展按键（方向键）
+        ch = _getch();
+        switch (ch) {
+            case 72: return KEY_UP;
+            case 80: return KEY_DOWN;
+            case 75: return KEY_LEFT;
+            case 77: return KEY_RIGHT;
+            default: return KEY_EXTENDED + ch;
+        }
+    }
+    return ch == '\n' ? KEY_ENTER : ch;
+}
+
+#else
+
+inline struct termios& savedTermios() {
+    static struct termios saved;
+    return saved;
+}
+
+inline void terminalInit() {}
+
+// 在作用域内把终端切到原始模式（关闭行缓冲和回显），离开作用域或 restore() 时恢复。
+// 保留 ISIG（Ctrl+C 仍可中断）和 OPOST（\n 仍输出为换行回车）
+class RawMode {
+public:
+    RawMode() : active_(false) {
+        if (!isatty(STDIN_FILENO) || tcgetattr(STDIN_FILENO, &savedTermios()) != 0) {
+            return; // 输入不是终端（重定向），不需要切换
+        }
+        struct termios raw = savedTermios();
+        raw.c_lflag &= ~(ICANON | ECHO);
+        raw.c_cc[VMIN] = 1;
+        raw.c_cc[VTIME] = 0;
+        active_ = tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0;
+    }
+    ~RawMode() { restore(); }
+
+    void restore() {
+        if (active_) {
+            tcsetattr(STDIN_FILENO, TCSANOW, &savedTermios());
+            active_ = false;
+        }
+    }
+
+private:
+    RawMode(const RawMode&);
+    RawMode& operator=(const RawMode&);
+    bool active_;
+};
+
+// 阻塞等待按键，最多等待 timeoutMs 毫秒（小于 0 表示一直等待）。有按键可读时返回 true
+inline bool waitForKey(int timeoutMs) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (true) {
+        int wait = -1;
+        if (timeoutMs >= 0) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+            wait = left > 0 ? (int)left : 0;
+        }
+        struct pollfd pfd = {STDIN_FILENO, POLLIN, 0};
+        int n = poll(&pfd, 1, wait);
+        if (n > 0) {
+            return true;
+        }
+        if (n == 0) {
+            return false; // 超时
+        }
+        // 被信号打断（如窗口大小改变），继续等待
+    }
+}
+
+// 读一个字节，timeoutMs 毫秒内没有数据、输入结束（EOF 或终端挂断）或出错时返回 -1
+inline int readByte(int timeoutMs) {
+    if (timeoutMs >= 0) {
+        struct pollfd pfd = {STDIN_FILENO, POLLIN, 0};
+        if (poll(&pfd, 1, timeoutMs) <= 0) {
+            return -1;
+        }
+    }
+    unsigned char c;
+    ssize_t n;
+    do {
+        n = read(STDIN_FILENO, &c, 1);
+    } while (n < 0 && errno == EINTR); // 被信号打断时重读
+    return n == 1 ? c : -1;
+}
+
+// 读取一个按键（阻塞）。方向键是 ESC [ A 这样的转义序列；
+// 单独的 ESC 后面短时间内不会再有字节，以此区分 Esc 键和转义序列
+inline int readKey() {
+    int ch = readByte(-1);
+    if (ch < 0) {
+        // 输入已结束：poll 会一直报告可读，当作 Esc 让调用方退出，而不是反复读到无效按键
+        return KEY_ESC;
+    }
+    if (ch == '\n' || ch == '\r') {
+        return KEY_ENTER;
+    }
+    if (ch != KEY_ESC) {
+        return ch;
+    }
+    int next = readByte(30);
+    if (next != '[' && next != 'O') {
+        return KEY_ESC;
+    }
+    int last = readByte(30);
+    while (last >= '0' && last <= '9') { // 跳过 ESC [ 1 ; 5 A 这类序列中的参数
+        last = readByte(30);
+        if (last == ';') last = readByte(30);
+    }
+    switch (last) {
+        case 'A': return KEY_UP;
+        case 'B': return KEY_DOWN;
+        case 'D': return KEY_LEFT;
+        case 'C': return KEY_RIGHT;
+        default: return KEY_EXTENDED + (last < 0 ? 0 : last);
+    }
+}
+
+#endif
+
+// 代替 system("PAUSE")：提示后等待任意键，不启动 shell 进程
+inline void pauseForKey() {
+    fputs("请按任意键继续. . .\n", stdout);
+    fflush(stdout);
+    RawMode raw;
+    readKey();
+}